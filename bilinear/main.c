@@ -1,9 +1,15 @@
 // bilinear mapping visualizer; map lines and the unit circle via mobius transforms
 #include "raylib.h"
+#include "rlgl.h"
+#include "../common/scene.h"
 #include <complex.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
@@ -19,11 +25,21 @@ typedef enum {
 typedef enum {
     TRANSFORM_IDENTITY,
     TRANSFORM_CIRCLE_AND_LINE_PRESERVING,
-    TRANSFORM_CIRCLE_TO_HALFPLANE
+    TRANSFORM_CIRCLE_TO_HALFPLANE,
+    TRANSFORM_CUSTOM,
+    TRANSFORM_COUNT
 } TransformType;
 
+typedef enum {
+    EDIT_NONE,
+    EDIT_HANDLES,
+    EDIT_THREE_POINTS,
+    EDIT_MODE_COUNT
+} EditMode;
+
 InputType currentInput = INPUT_LINES;
 TransformType currentTransform = TRANSFORM_IDENTITY;
+EditMode editMode = EDIT_NONE;
 
 double complex a, b, c, d;
 
@@ -57,26 +73,1655 @@ void UpdateTransformParameters() {
             c = 1.0 + 0.0*I;
             d = -1.0 + 0.0*I;
             break;
+            
+        case TRANSFORM_CUSTOM:
+        case TRANSFORM_COUNT:
+            // coefficients come from the drag handles
+            break;
+    }
+}
+
+#define POLE_EPSILON 1e-10
+#define MAX_POLYLINE_POINTS 1024
+
+static inline double SquaredNorm(double complex z) {
+    return creal(z) * creal(z) + cimag(z) * cimag(z);
+}
+
+// w = (m0 z + m1)/(m2 z + m3) over a batch, in split real arithmetic so the loop vectorizes:
+// the quotient is N conj(D) / |D|^2, and a point whose |D|^2 is negligible next to
+// |m2 z|^2 + |m3|^2 is on the pole and comes out infinite; returns how many were
+int ApplyMobiusBatch(const double complex m[4], const double complex* z, double complex* w, int count) {
+    double ar = creal(m[0]), ai = cimag(m[0]), br = creal(m[1]), bi = cimag(m[1]);
+    double cr = creal(m[2]), ci = cimag(m[2]), dr = creal(m[3]), di = cimag(m[3]);
+    double dNorm = dr * dr + di * di;
+    int poles = 0;
+    for (int i = 0; i < count; i++) {
+        double x = creal(z[i]), y = cimag(z[i]);
+        double czr = cr * x - ci * y, czi = cr * y + ci * x;
+        double qr = czr + dr, qi = czi + di;
+        double nr = ar * x - ai * y + br, ni = ar * y + ai * x + bi;
+        double q2 = qr * qr + qi * qi;
+        if (q2 <= POLE_EPSILON * POLE_EPSILON * (czr * czr + czi * czi + dNorm)) {
+            w[i] = INFINITY;
+            poles++;
+            continue;
+        }
+        double inverse = 1.0 / q2;
+        w[i] = (nr * qr + ni * qi) * inverse + (ni * qr - nr * qi) * inverse * I;
+    }
+    return poles;
+}
+
+// the denominator is affine along a segment, so the segment passes the pole where the
+// denominator passes zero; true when zero lies within half the segment's length of it
+bool SegmentNearPole(double complex d0, double complex d1) {
+    double complex edge = d1 - d0;
+    double length2 = SquaredNorm(edge);
+    double t = length2 > 0.0 ? -creal(conj(edge) * d0) / length2 : 0.0;
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    return SquaredNorm(d0 + t * edge) < 0.25 * length2;
+}
+
+// maps a polyline once per vertex, so adjacent segments share their images; breaks[i] marks
+// the segment i -> i + 1 where it passes the pole, since the chord between its images would
+// cut across the plane instead of running out through infinity; returns the break count
+int MapPolyline(const double complex m[4], const double complex* z, double complex* w, unsigned char* breaks, int count) {
+    ApplyMobiusBatch(m, z, w, count);
+    int broken = 0;
+    double complex previous = m[2] * z[0] + m[3];
+    for (int i = 0; i + 1 < count; i++) {
+        double complex next = m[2] * z[i + 1] + m[3];
+        breaks[i] = SegmentNearPole(previous, next) || !isfinite(creal(w[i])) || !isfinite(creal(w[i + 1]));
+        broken += breaks[i];
+        previous = next;
+    }
+    return broken;
+}
+
+void DrawMappedPolyline(const double complex m[4], const double complex* z, int count, Color color) {
+    double complex w[MAX_POLYLINE_POINTS];
+    unsigned char breaks[MAX_POLYLINE_POINTS];
+    if (count > MAX_POLYLINE_POINTS) count = MAX_POLYLINE_POINTS;
+    if (count < 2) return;
+    MapPolyline(m, z, w, breaks, count);
+    Vector2 previous = ComplexToScreen(w[0]);
+    for (int i = 1; i < count; i++) {
+        Vector2 next = ComplexToScreen(w[i]);
+        if (!breaks[i - 1]) DrawLineV(previous, next, color);
+        previous = next;
     }
 }
 
 double complex BilinearTransform(double complex z) {
-    double complex numerator = a * z + b;
-    double complex denominator = c * z + d;
+    double complex m[4] = { a, b, c, d }, w;
+    // callers get a far finite stand-in for infinity
+    if (ApplyMobiusBatch(m, &z, &w, 1) > 0) return 1e10 + 1e10*I;
+    return w;
+}
+
+// generalized circle A|z|^2 + conj(B) z + B conj(z) + C = 0, i.e. v* H v = 0 for v = (z, 1)
+// and H = [[A, B], [conj(B), C]]; A = 0 is a line, which a circle through the pole becomes
+typedef struct {
+    double A;
+    double complex B;
+    double C;
+} GeneralizedCircle;
+
+GeneralizedCircle CircleFromCenter(double complex center, double radius) {
+    // |z - c|^2 = r^2  ->  |z|^2 - conj(c) z - c conj(z) + |c|^2 - r^2 = 0
+    return (GeneralizedCircle){ 1.0, -center, creal(center) * creal(center) + cimag(center) * cimag(center) - radius * radius };
+}
+
+GeneralizedCircle LineThrough(double complex p, double complex q) {
+    // 2 Re(conj(n) z) = 2 Re(conj(n) p) with n normal to q - p
+    double complex n = I * (q - p);
+    return (GeneralizedCircle){ 0.0, n, -2.0 * creal(conj(n) * p) };
+}
+
+// closed-form images under w = M z: H' = (M^-1)* H M^-1
+void TransformCircles(const double complex m[4], const GeneralizedCircle* in, GeneralizedCircle* out, int count) {
+    // M^-1 up to scale; the equation is homogeneous so the determinant can be dropped
+    double complex m00 = m[3], m01 = -m[1], m10 = -m[2], m11 = m[0];
+    for (int i = 0; i < count; i++) {
+        double complex h00 = in[i].A, h01 = in[i].B, h10 = conj(in[i].B), h11 = in[i].C;
+        // K = H M^-1, then H' = (M^-1)* K
+        double complex k00 = h00 * m00 + h01 * m10, k01 = h00 * m01 + h01 * m11;
+        double complex k10 = h10 * m00 + h11 * m10, k11 = h10 * m01 + h11 * m11;
+        GeneralizedCircle image = {
+            creal(conj(m00) * k00 + conj(m10) * k10),
+            conj(m00) * k01 + conj(m10) * k11,
+            creal(conj(m01) * k01 + conj(m11) * k11)
+        };
+        double norm = fmax(fmax(fabs(image.A), cabs(image.B)), fabs(image.C));
+        if (norm > 0.0) {
+            image.A /= norm;
+            image.B /= norm;
+            image.C /= norm;
+        }
+        out[i] = image;
+    }
+}
+
+// images under the current transform
+void MobiusImages(const GeneralizedCircle* in, GeneralizedCircle* out, int count) {
+    double complex m[4] = { a, b, c, d };
+    TransformCircles(m, in, out, count);
+}
+
+GeneralizedCircle MobiusImage(GeneralizedCircle g) {
+    GeneralizedCircle image;
+    MobiusImages(&g, &image, 1);
+    return image;
+}
+
+#define INPUT_LINE_COUNT 10
+
+// the input families never change, so their matrices are built once; their images are
+// recomputed in one batch whenever the coefficients move
+#define SAMPLED_POINTS 512
+
+GeneralizedCircle inputLines[INPUT_LINE_COUNT];
+GeneralizedCircle inputCircle;
+GeneralizedCircle imageLines[INPUT_LINE_COUNT];
+GeneralizedCircle imageCircle;
+double complex imageCoefficients[4];
+bool imagesValid = false;
+// the same families as polylines, for drawing the images by sampling instead (S)
+double complex sampledLines[INPUT_LINE_COUNT][SAMPLED_POINTS];
+double complex sampledCircle[SAMPLED_POINTS + 1];
+bool sampledImages = false;
+
+void InitInputFamilies() {
+    int k = 0;
+    for (int i = -5; i <= 5; i++) {
+        if (i == 0) continue;
+        // x = tan(theta) runs over the whole line, so only infinity itself is left out
+        for (int j = 0; j < SAMPLED_POINTS; j++) {
+            sampledLines[k][j] = tan(M_PI * ((j + 0.5) / SAMPLED_POINTS - 0.5)) + i*I;
+        }
+        inputLines[k++] = LineThrough(i*I, 1.0 + i*I);
+    }
+    inputCircle = CircleFromCenter(0.0, 1.0);
+    for (int j = 0; j <= SAMPLED_POINTS; j++) {
+        sampledCircle[j] = cexp(2.0 * M_PI * I * j / SAMPLED_POINTS);
+    }
+}
+
+void UpdateImages() {
+    if (imagesValid && imageCoefficients[0] == a && imageCoefficients[1] == b &&
+        imageCoefficients[2] == c && imageCoefficients[3] == d) {
+        return;
+    }
+    MobiusImages(inputLines, imageLines, INPUT_LINE_COUNT);
+    MobiusImages(&inputCircle, &imageCircle, 1);
+    imageCoefficients[0] = a;
+    imageCoefficients[1] = b;
+    imageCoefficients[2] = c;
+    imageCoefficients[3] = d;
+    imagesValid = true;
+}
+
+typedef enum {
+    FLOW_IDENTITY,
+    FLOW_ELLIPTIC,
+    FLOW_PARABOLIC,
+    FLOW_HYPERBOLIC,
+    FLOW_LOXODROMIC
+} FlowClass;
+
+// one-parameter subgroup M^t = exp(t log M) through the target, with M normalized into
+// SL(2,C) and its sign picked so the path is the short way round
+typedef struct {
+    double complex target[4];  // coefficients as given, restored exactly at t = 1
+    double complex m[4];       // normalized: det = 1, Re(trace) >= 0
+    double complex lambda;     // eigenvalue with |lambda| >= 1, lambda + 1/lambda = trace
+    double complex logLambda;
+    FlowClass kind;
+    double complex fixedPoints[2];
+    int finiteFixedPoints;
+    bool fixedAtInfinity;
+    float t;
+    bool animating;
+    bool valid;                // false for a singular matrix, which has no flow
+} MobiusFlow;
+
+MobiusFlow flow = { 0 };
+
+void MatrixPower(const MobiusFlow* f, double t, double complex out[4]) {
+    const double complex* m = f->m;
+    if (f->kind == FLOW_IDENTITY || f->kind == FLOW_PARABOLIC) {
+        // M = I + N with N nilpotent, so M^t = I + tN
+        out[0] = 1.0 + t * (m[0] - 1.0);
+        out[1] = t * m[1];
+        out[2] = t * m[2];
+        out[3] = 1.0 + t * (m[3] - 1.0);
+        return;
+    }
+    // sylvester's formula over the eigenvalues lambda and 1/lambda
+    double complex inverse = 1.0 / f->lambda;
+    double complex up = cexp(t * f->logLambda), down = cexp(-t * f->logLambda);
+    double complex scale = 1.0 / (f->lambda - inverse);
+    out[0] = (up * (m[0] - inverse) - down * (m[0] - f->lambda)) * scale;
+    out[1] = (up - down) * m[1] * scale;
+    out[2] = (up - down) * m[2] * scale;
+    out[3] = (up * (m[3] - inverse) - down * (m[3] - f->lambda)) * scale;
+}
+
+// takes a, b, c, d as the flow target; with animate the coefficients restart from the identity
+void SetFlowTarget(bool animate) {
+    double complex raw[4] = { a, b, c, d };
+    for (int i = 0; i < 4; i++) flow.target[i] = raw[i];
+    flow.t = 1.0f;
+    flow.animating = false;
+    double complex det = a * d - b * c;
+    flow.valid = cabs(det) > 1e-12;
+    if (!flow.valid) return;
+    
+    double complex root = csqrt(det);
+    for (int i = 0; i < 4; i++) flow.m[i] = raw[i] / root;
+    if (creal(flow.m[0] + flow.m[3]) < 0.0) {
+        for (int i = 0; i < 4; i++) flow.m[i] = -flow.m[i];
+    }
+    const double complex* m = flow.m;
+    double complex trace = m[0] + m[3];
+    double eps = 1e-9;
+    if (cabs(m[0] - 1.0) + cabs(m[1]) + cabs(m[2]) + cabs(m[3] - 1.0) < eps) {
+        flow.kind = FLOW_IDENTITY;
+    } else if (cabs(trace * trace - 4.0) < eps) {
+        flow.kind = FLOW_PARABOLIC;
+    } else if (fabs(cimag(trace)) < eps) {
+        flow.kind = fabs(creal(trace)) < 2.0 ? FLOW_ELLIPTIC : FLOW_HYPERBOLIC;
+    } else {
+        flow.kind = FLOW_LOXODROMIC;
+    }
+    flow.lambda = 0.5 * (trace + csqrt(trace * trace - 4.0));
+    if (cabs(flow.lambda) < 1.0) flow.lambda = 1.0 / flow.lambda;
+    flow.logLambda = clog(flow.lambda);
+    
+    // fixed points solve c z^2 + (d - a) z - b = 0
+    flow.finiteFixedPoints = 0;
+    flow.fixedAtInfinity = false;
+    if (flow.kind != FLOW_IDENTITY) {
+        if (cabs(m[2]) < eps) {
+            flow.fixedAtInfinity = true;
+            if (cabs(m[3] - m[0]) > eps) flow.fixedPoints[flow.finiteFixedPoints++] = m[1] / (m[3] - m[0]);
+        } else {
+            double complex root = csqrt((m[0] - m[3]) * (m[0] - m[3]) + 4.0 * m[1] * m[2]);
+            flow.fixedPoints[flow.finiteFixedPoints++] = (m[0] - m[3] + root) / (2.0 * m[2]);
+            if (flow.kind != FLOW_PARABOLIC) flow.fixedPoints[flow.finiteFixedPoints++] = (m[0] - m[3] - root) / (2.0 * m[2]);
+        }
+    }
+    
+    if (animate) {
+        flow.t = 0.0f;
+        flow.animating = true;
+        a = 1.0;
+        b = 0.0;
+        c = 0.0;
+        d = 1.0;
+    }
+}
+
+void AdvanceFlow() {
+    if (!flow.animating) return;
+    flow.t += 0.015f;
+    if (flow.t >= 1.0f || !flow.valid) {
+        flow.t = 1.0f;
+        flow.animating = false;
+        a = flow.target[0];
+        b = flow.target[1];
+        c = flow.target[2];
+        d = flow.target[3];
+        return;
+    }
+    double complex m[4];
+    MatrixPower(&flow, flow.t, m);
+    a = m[0];
+    b = m[1];
+    c = m[2];
+    d = m[3];
+}
+
+#define FLOW_SEEDS_X 48
+#define FLOW_SEEDS_Y 36
+#define FLOW_SEEDS (FLOW_SEEDS_X * FLOW_SEEDS_Y)
+#define FLOW_STEPS 24
+
+// flow lines are the orbits s -> M^s z0 for s in [0, 1]; they depend only on the target,
+// so they are rebuilt one matrix per step when it changes, while the moving markers cost
+// a single batched apply per frame
+double complex flowSeeds[FLOW_SEEDS];
+double complex flowLines[FLOW_STEPS][FLOW_SEEDS];
+unsigned char flowBreaks[FLOW_STEPS - 1][FLOW_SEEDS];
+double complex flowMarkers[FLOW_SEEDS];
+double complex flowLinesTarget[4];
+bool flowLinesValid = false;
+bool showFlowLines = false;
+
+void InitFlowSeeds() {
+    for (int y = 0; y < FLOW_SEEDS_Y; y++) {
+        for (int x = 0; x < FLOW_SEEDS_X; x++) {
+            Vector2 screen = { (x + 0.5f) * SCREEN_WIDTH / FLOW_SEEDS_X, (y + 0.5f) * SCREEN_HEIGHT / FLOW_SEEDS_Y };
+            flowSeeds[y * FLOW_SEEDS_X + x] = ScreenToComplex(screen);
+        }
+    }
+}
+
+void UpdateFlowLines() {
+    bool same = flowLinesValid;
+    for (int i = 0; i < 4 && same; i++) same = flowLinesTarget[i] == flow.target[i];
+    if (same) return;
+    double complex previous[4] = { 1.0, 0.0, 0.0, 1.0 };
+    for (int k = 0; k < FLOW_STEPS; k++) {
+        double complex m[4];
+        MatrixPower(&flow, (double)k / (FLOW_STEPS - 1), m);
+        ApplyMobiusBatch(m, flowSeeds, flowLines[k], FLOW_SEEDS);
+        // between two steps the denominator moves almost linearly, so the same test finds
+        // the orbits that pass through infinity
+        for (int i = 0; k > 0 && i < FLOW_SEEDS; i++) {
+            flowBreaks[k - 1][i] = SegmentNearPole(previous[2] * flowSeeds[i] + previous[3], m[2] * flowSeeds[i] + m[3]);
+        }
+        for (int e = 0; e < 4; e++) previous[e] = m[e];
+    }
+    for (int i = 0; i < 4; i++) flowLinesTarget[i] = flow.target[i];
+    flowLinesValid = true;
+}
+
+void DrawFlowLines() {
+    if (!showFlowLines || !flow.valid || flow.kind == FLOW_IDENTITY) return;
+    UpdateFlowLines();
+    double complex m[4];
+    MatrixPower(&flow, flow.t, m);
+    ApplyMobiusBatch(m, flowSeeds, flowMarkers, FLOW_SEEDS);
+    
+    Color line = ColorAlpha(DARKPURPLE, 0.25f);
+    for (int i = 0; i < FLOW_SEEDS; i++) {
+        Vector2 previous = ComplexToScreen(flowLines[0][i]);
+        for (int k = 1; k < FLOW_STEPS; k++) {
+            Vector2 next = ComplexToScreen(flowLines[k][i]);
+            // a step that passed the pole, or still jumps across the screen, is left out
+            if (!flowBreaks[k - 1][i] && fabsf(next.x - previous.x) + fabsf(next.y - previous.y) < SCREEN_WIDTH / 4 &&
+                isfinite(next.x) && isfinite(previous.x)) {
+                DrawLineV(previous, next, line);
+            }
+            previous = next;
+        }
+        Vector2 marker = ComplexToScreen(flowMarkers[i]);
+        if (isfinite(marker.x) && isfinite(marker.y)) DrawCircleV(marker, 1.5f, DARKPURPLE);
+    }
+}
+
+void DrawFlowInfo() {
+    if (!flow.valid) {
+        DrawText("Flow: singular matrix", SCREEN_WIDTH - 250, 10, 15, MAROON);
+        return;
+    }
+    const char* kindNames[] = { "identity", "elliptic", "parabolic", "hyperbolic", "loxodromic" };
+    double complex trace = flow.m[0] + flow.m[3];
+    DrawText(TextFormat("Class: %s, tr = %.2f%+.2fi", kindNames[flow.kind], creal(trace), cimag(trace)),
+             SCREEN_WIDTH - 330, 10, 15, DARKPURPLE);
+    DrawText(TextFormat("Flow t = %.2f%s", flow.t, flow.fixedAtInfinity ? "   fixed: infinity" : ""), SCREEN_WIDTH - 330, 30, 15, DARKPURPLE);
+    for (int k = 0; k < flow.finiteFixedPoints; k++) {
+        Vector2 p = ComplexToScreen(flow.fixedPoints[k]);
+        DrawLineEx((Vector2){ p.x - 6, p.y - 6 }, (Vector2){ p.x + 6, p.y + 6 }, 2.0f, DARKPURPLE);
+        DrawLineEx((Vector2){ p.x - 6, p.y + 6 }, (Vector2){ p.x + 6, p.y - 6 }, 2.0f, DARKPURPLE);
+        DrawText(TextFormat("%.2f%+.2fi", creal(flow.fixedPoints[k]), cimag(flow.fixedPoints[k])), p.x + 8, p.y + 4, 12, DARKPURPLE);
+    }
+}
+
+// drag handles: in EDIT_HANDLES the coefficients themselves are points in the plane; in
+// EDIT_THREE_POINTS three source points and their targets pin down the map
+double complex sourcePoints[3] = { -0.5, 0.5*I, 0.5 };
+double complex targetPoints[3] = { -0.5, 0.5*I, 0.5 };
+int draggedHandle = -1;
+
+// matrix of the map sending p0, p1, p2 to 0, 1, infinity
+void CrossRatioMatrix(const double complex* p, double complex m[4]) {
+    m[0] = p[1] - p[2];
+    m[1] = -p[0] * (p[1] - p[2]);
+    m[2] = p[1] - p[0];
+    m[3] = -p[2] * (p[1] - p[0]);
+}
+
+// solves M = T^-1 S for the map with M(source_k) = target_k; returns false for repeated points
+bool SolveThreePointMap() {
+    double complex S[4], T[4];
+    CrossRatioMatrix(sourcePoints, S);
+    CrossRatioMatrix(targetPoints, T);
+    if (cabs(S[0] * S[3] - S[1] * S[2]) < 1e-12 || cabs(T[0] * T[3] - T[1] * T[2]) < 1e-12) return false;
+    double complex Tinv[4] = { T[3], -T[1], -T[2], T[0] };
+    double complex m[4] = {
+        Tinv[0] * S[0] + Tinv[1] * S[2], Tinv[0] * S[1] + Tinv[1] * S[3],
+        Tinv[2] * S[0] + Tinv[3] * S[2], Tinv[2] * S[1] + Tinv[3] * S[3]
+    };
+    // scale to determinant one so the printed coefficients stay readable
+    double complex root = csqrt(m[0] * m[3] - m[1] * m[2]);
+    if (cabs(root) < 1e-12) return false;
+    a = m[0] / root;
+    b = m[1] / root;
+    c = m[2] / root;
+    d = m[3] / root;
+    return true;
+}
+
+int HandleCount() {
+    return editMode == EDIT_HANDLES ? 4 : (editMode == EDIT_THREE_POINTS ? 6 : 0);
+}
+
+double complex* HandlePoint(int handle) {
+    if (editMode == EDIT_HANDLES) {
+        double complex* coefficients[4] = { &a, &b, &c, &d };
+        return coefficients[handle];
+    }
+    return handle < 3 ? &sourcePoints[handle] : &targetPoints[handle - 3];
+}
+
+void UpdateDragging() {
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        draggedHandle = -1;
+        float best = 12.0f;
+        for (int h = 0; h < HandleCount(); h++) {
+            Vector2 p = ComplexToScreen(*HandlePoint(h));
+            float distance = hypotf(p.x - mouse.x, p.y - mouse.y);
+            if (distance < best) {
+                best = distance;
+                draggedHandle = h;
+            }
+        }
+    }
+    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
+        draggedHandle = -1;
+    }
+    if (draggedHandle < 0 || draggedHandle >= HandleCount() || !IsMouseButtonDown(MOUSE_LEFT_BUTTON)) return;
+    
+    double complex* point = HandlePoint(draggedHandle);
+    double complex previous = *point;
+    *point = ScreenToComplex(mouse);
+    if (editMode == EDIT_THREE_POINTS && !SolveThreePointMap()) {
+        *point = previous;
+        SolveThreePointMap();
+    }
+    currentTransform = TRANSFORM_CUSTOM;
+    SetFlowTarget(false);
+}
+
+void DrawHandles() {
+    const char* coefficientNames[4] = { "a", "b", "c", "d" };
+    for (int h = 0; h < HandleCount(); h++) {
+        Vector2 p = ComplexToScreen(*HandlePoint(h));
+        Color color = editMode == EDIT_HANDLES ? DARKGREEN : (h < 3 ? BLUE : RED);
+        if (h == draggedHandle) color = ORANGE;
+        DrawCircleV(p, 6.0f, color);
+        const char* label = editMode == EDIT_HANDLES ? coefficientNames[h] : TextFormat(h < 3 ? "z%d" : "w%d", h % 3 + 1);
+        DrawText(label, p.x + 8, p.y - 8, 15, color);
+    }
+    if (editMode == EDIT_THREE_POINTS) {
+        for (int k = 0; k < 3; k++) {
+            DrawLineV(ComplexToScreen(sourcePoints[k]), ComplexToScreen(targetPoints[k]), ColorAlpha(GRAY, 0.5f));
+        }
+    }
+}
+
+// clips the screen-space line p + t dir to the viewport (liang-barsky) and draws what is left
+void DrawClippedLine(Vector2 p, Vector2 dir, Color color) {
+    double t0 = -INFINITY, t1 = INFINITY;
+    double origin[2] = { p.x, p.y }, delta[2] = { dir.x, dir.y }, high[2] = { SCREEN_WIDTH, SCREEN_HEIGHT };
+    for (int axis = 0; axis < 2; axis++) {
+        if (fabs(delta[axis]) < 1e-12) {
+            if (origin[axis] < 0.0 || origin[axis] > high[axis]) return;
+            continue;
+        }
+        double ta = (0.0 - origin[axis]) / delta[axis], tb = (high[axis] - origin[axis]) / delta[axis];
+        t0 = fmax(t0, fmin(ta, tb));
+        t1 = fmin(t1, fmax(ta, tb));
+    }
+    if (t0 >= t1) return;
+    DrawLineV((Vector2){ p.x + t0 * dir.x, p.y + t0 * dir.y }, (Vector2){ p.x + t1 * dir.x, p.y + t1 * dir.y }, color);
+}
+
+// the part of a screen-space circle that can be visible; false when the circle misses the
+// screen or encloses all of it
+bool VisibleArc(double cx, double cy, double radius, double* start, double* span) {
+    double nearestX = fmin(fmax(cx, 0.0), SCREEN_WIDTH), nearestY = fmin(fmax(cy, 0.0), SCREEN_HEIGHT);
+    if (hypot(nearestX - cx, nearestY - cy) > radius) return false;
+    double corners[4][2] = { { 0, 0 }, { SCREEN_WIDTH, 0 }, { SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, SCREEN_HEIGHT } };
+    bool screenInside = true;
+    for (int k = 0; k < 4; k++) {
+        if (hypot(corners[k][0] - cx, corners[k][1] - cy) >= radius) screenInside = false;
+    }
+    if (screenInside) return false;
+    
+    *start = 0.0;
+    *span = 2.0 * PI;
+    if (cx < 0.0 || cx > SCREEN_WIDTH || cy < 0.0 || cy > SCREEN_HEIGHT) {
+        // seen from an outside centre the screen spans less than pi, so the corners bound the arc
+        double facing = atan2(SCREEN_HEIGHT / 2.0 - cy, SCREEN_WIDTH / 2.0 - cx);
+        double lo = 0.0, hi = 0.0;
+        for (int k = 0; k < 4; k++) {
+            double offset = remainder(atan2(corners[k][1] - cy, corners[k][0] - cx) - facing, 2.0 * PI);
+            lo = fmin(lo, offset);
+            hi = fmax(hi, offset);
+        }
+        *start = facing + lo;
+        *span = hi - lo;
+    }
+    return true;
+}
+
+// draws a generalized circle in one pass: lines are clipped to the screen, circles are
+// tessellated only over the arc that can be visible, with segments sized so the chord
+// stays within a quarter pixel of the true arc
+void DrawGeneralizedCircle(GeneralizedCircle g, Color color) {
+    double norm = fmax(cabs(g.B), fabs(g.C));
+    if (fabs(g.A) <= 1e-12 * norm) {
+        if (cabs(g.B) < 1e-12) return;
+        // 2 Re(conj(B) z) + C = 0: the point closest to the origin and the direction i B
+        double complex foot = -g.C * g.B / (2.0 * (creal(g.B) * creal(g.B) + cimag(g.B) * cimag(g.B)));
+        double complex along = I * g.B / cabs(g.B);
+        DrawClippedLine(ComplexToScreen(foot), (Vector2){ creal(along), -cimag(along) }, color);
+        return;
+    }
+    double complex center = -g.B / g.A;
+    double radiusSquared = (creal(g.B) * creal(g.B) + cimag(g.B) * cimag(g.B)) / (g.A * g.A) - g.C / g.A;
+    if (radiusSquared <= 0.0) return;
+    
+    double radius = sqrt(radiusSquared) * SCALE;
+    double cx = ORIGIN_X + creal(center) * SCALE, cy = ORIGIN_Y - cimag(center) * SCALE;
+    double start, span;
+    if (!VisibleArc(cx, cy, radius, &start, &span)) return;
+    double tolerance = 0.25;
+    double step = radius > tolerance ? 2.0 * acos(1.0 - tolerance / radius) : span;
+    int segments = (int)ceil(span / step);
+    if (segments < 8) segments = 8;
+    if (segments > 4096) segments = 4096;
+    Vector2 previous = { cx + radius * cos(start), cy + radius * sin(start) };
+    for (int k = 1; k <= segments; k++) {
+        double angle = start + span * k / segments;
+        Vector2 next = { cx + radius * cos(angle), cy + radius * sin(angle) };
+        DrawLineV(previous, next, color);
+        previous = next;
+    }
+}
+
+#define MAX_WORKER_THREADS 16
+
+// how many workers the cores can keep busy, at most MAX_WORKER_THREADS
+int WorkerCount() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores < 1 ? 1 : (cores > MAX_WORKER_THREADS ? MAX_WORKER_THREADS : (int)cores);
+}
+
+// runs worker on each of count records laid out stride bytes apart, every one but the first
+// on its own thread and the first on this one; a record whose thread cannot start runs here
+// too. returns once all of them are done
+void RunWorkers(void* (*worker)(void*), void* records, size_t stride, int count) {
+    pthread_t threads[MAX_WORKER_THREADS];
+    bool started[MAX_WORKER_THREADS] = { false };
+    char* base = (char*)records;
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, worker, base + i * stride) == 0;
+        if (!started[i]) worker(base + i * stride);
+    }
+    if (count > 0) worker(base);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+// image of the unit disk, filled by pulling every pixel back through the inverse map;
+// re-rendered only when the coefficients change
+typedef struct {
+    Color* pixels;
+    Texture2D texture;
+    double complex a, b, c, d;  // coefficients the texture holds
+    bool valid;
+} RegionFill;
+
+RegionFill regionFill = { 0 };
+
+typedef struct {
+    Color* pixels;
+    int firstRow;
+    int lastRow;
+    Color fill;
+} FillBand;
+
+void* FillRows(void* arg) {
+    FillBand* band = (FillBand*)arg;
+    for (int y = band->firstRow; y < band->lastRow; y++) {
+        Color* row = band->pixels + (size_t)y * SCREEN_WIDTH;
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            double complex w = ScreenToComplex((Vector2){ x + 0.5f, y + 0.5f });
+            // |z| <= 1 for z = (dw - b)/(a - cw), compared without the division so the pole needs no care
+            double complex numerator = d * w - b;
+            double complex denominator = a - c * w;
+            double n2 = creal(numerator) * creal(numerator) + cimag(numerator) * cimag(numerator);
+            double d2 = creal(denominator) * creal(denominator) + cimag(denominator) * cimag(denominator);
+            row[x] = n2 <= d2 ? band->fill : BLANK;
+        }
+    }
+    return NULL;
+}
+
+void InitRegionFill() {
+    Image image = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLANK);
+    regionFill.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    regionFill.pixels = (Color*)malloc((size_t)SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Color));
+    regionFill.valid = false;
+}
+
+void UpdateRegionFill() {
+    if (regionFill.pixels == NULL) return;
+    if (regionFill.valid && regionFill.a == a && regionFill.b == b && regionFill.c == c && regionFill.d == d) return;
+    
+    // one band of rows per core
+    int bandCount = WorkerCount();
+    FillBand bands[MAX_WORKER_THREADS];
+    Color fill = ColorAlpha(RED, 0.2f);
+    for (int i = 0; i < bandCount; i++) {
+        bands[i] = (FillBand){ regionFill.pixels, SCREEN_HEIGHT * i / bandCount, SCREEN_HEIGHT * (i + 1) / bandCount, fill };
+    }
+    RunWorkers(FillRows, bands, sizeof(FillBand), bandCount);
+    
+    UpdateTexture(regionFill.texture, regionFill.pixels);
+    regionFill.a = a;
+    regionFill.b = b;
+    regionFill.c = c;
+    regionFill.d = d;
+    regionFill.valid = true;
+}
+
+void UnloadRegionFill() {
+    UnloadTexture(regionFill.texture);
+    free(regionFill.pixels);
+    regionFill = (RegionFill){ 0 };
+}
+
+// limit sets of kleinian groups given by circle pairings: generator g maps the outside of
+// the disk of its inverse into its own disk, so the disk of a reduced word g1...gk is
+// g1...g(k-1) applied to the disk of gk, and these nest; a depth-first walk over reduced
+// words stops once a disk is under a pixel or off screen and plots it as a limit point.
+// reduced words can still name the same element when the generators satisfy a relation, so
+// disks of a few pixels and up go into a table shared by all threads, and a subtree whose
+// disk is already there has been walked
+#define MAX_GENERATOR_PAIRS 3
+#define MAX_GENERATORS (2 * MAX_GENERATOR_PAIRS)
+#define LIMIT_SEEN_SLOTS (1 << 18)
+#define LIMIT_SEEN_RADIUS 4.0      // pixels; smaller disks are too many to record and too cheap to matter
+
+typedef struct {
+    const char* name;
+    int count;                              // generators; g and g + count/2 are inverses
+    double complex m[MAX_GENERATORS][4];    // a, b, c, d of each generator, determinant one
+    GeneralizedCircle disks[MAX_GENERATORS];
+} KleinianGroup;
+
+// pairs the circles (P, r) and (Q, s): z -> Q + sr/(z - P) maps the outside of the first
+// into the inside of the second, and its inverse does the reverse
+void AddCirclePairing(KleinianGroup* group, double complex P, double r, double complex Q, double s) {
+    int pairs = group->count / 2;
+    // shift the existing inverses up to keep g and g + count/2 paired
+    for (int g = group->count - 1; g >= pairs; g--) {
+        for (int i = 0; i < 4; i++) group->m[g + 1][i] = group->m[g][i];
+        group->disks[g + 1] = group->disks[g];
+    }
+    double complex root = csqrt(-s * r);
+    double complex forward[4] = { Q / root, (s * r - Q * P) / root, 1.0 / root, -P / root };
+    for (int i = 0; i < 4; i++) group->m[pairs][i] = forward[i];
+    group->m[group->count + 1][0] = forward[3];
+    group->m[group->count + 1][1] = -forward[1];
+    group->m[group->count + 1][2] = -forward[2];
+    group->m[group->count + 1][3] = forward[0];
+    group->disks[pairs] = CircleFromCenter(Q, s);
+    group->disks[group->count + 1] = CircleFromCenter(P, r);
+    group->count += 2;
+}
+
+KleinianGroup ApollonianGroup() {
+    // a(z) = z + 2i and b(z) = z/(1 - z), whose four disks kiss: tr[a, b] = -2
+    KleinianGroup group = { .name = "Apollonian gasket (kissing Schottky)", .count = 4 };
+    double complex ma[4] = { 1.0, 2.0*I, 0.0, 1.0 }, mb[4] = { 1.0, 0.0, -1.0, 1.0 };
+    for (int i = 0; i < 4; i++) {
+        group.m[0][i] = ma[i];
+        group.m[1][i] = mb[i];
+    }
+    double complex inverses[2][4] = { { 1.0, -2.0*I, 0.0, 1.0 }, { 1.0, 0.0, 1.0, 1.0 } };
+    for (int i = 0; i < 4; i++) {
+        group.m[2][i] = inverses[0][i];
+        group.m[3][i] = inverses[1][i];
+    }
+    group.disks[0] = (GeneralizedCircle){ 0.0, -I, 2.0 };  // Im z > 1
+    group.disks[1] = CircleFromCenter(-1.0, 1.0);
+    group.disks[2] = (GeneralizedCircle){ 0.0, I, 2.0 };   // Im z < -1
+    group.disks[3] = CircleFromCenter(1.0, 1.0);
+    return group;
+}
+
+KleinianGroup SchottkyGroup() {
+    KleinianGroup group = { .name = "Schottky group, two generators", .count = 0 };
+    AddCirclePairing(&group, -2.5, 1.7, 2.5, 1.7);
+    AddCirclePairing(&group, -2.5*I, 1.7, 2.5*I, 1.7);
+    return group;
+}
+
+KleinianGroup ThreePairSchottkyGroup() {
+    KleinianGroup group = { .name = "Schottky group, three generators", .count = 0 };
+    for (int k = 0; k < 3; k++) {
+        double complex u = cexp(I * PI * k / 3.0);
+        AddCirclePairing(&group, -2.6 * u, 1.28, 2.6 * u, 1.28);
+    }
+    return group;
+}
+
+typedef struct {
+    const KleinianGroup* group;
+    int (*tasks)[2];            // depth-two subtrees: first generator, second generator
+    int taskCount;
+    atomic_int nextTask;
+    int maxDepth;
+    _Atomic uint64_t* seen;     // disk keys, 0 for an empty slot; NULL turns the dedup off
+} LimitJob;
+
+typedef struct {
+    LimitJob* job;
+    unsigned char* coverage;    // per-thread pixel mask, merged after the walk
+    long long words;
+    long long duplicates;
+} LimitWalker;
+
+void MultiplyMatrices(const double complex l[4], const double complex r[4], double complex out[4]) {
+    double complex m[4] = {
+        l[0] * r[0] + l[1] * r[2], l[0] * r[1] + l[1] * r[3],
+        l[2] * r[0] + l[3] * r[2], l[2] * r[1] + l[3] * r[3]
+    };
+    for (int i = 0; i < 4; i++) out[i] = m[i];
+}
+
+// true when the disk with this screen center and radius was seen before, recording it if not;
+// keys round to an eighth of a pixel, so two words landing on one disk share a key
+bool SeenLimitDisk(LimitJob* job, double x, double y, double radius) {
+    if (job->seen == NULL) return false;
+    uint64_t key = (uint64_t)(int64_t)llround(x * 8.0) * 0x9E3779B97F4A7C15ULL;
+    key ^= (uint64_t)(int64_t)llround(y * 8.0) * 0xC2B2AE3D27D4EB4FULL;
+    key ^= (uint64_t)(int64_t)llround(radius * 8.0) * 0x165667B19E3779F9ULL;
+    key ^= key >> 29;
+    if (key == 0) key = 1;
+    for (uint64_t probe = 0; probe < 64; probe++) {
+        _Atomic uint64_t* slot = &job->seen[(key + probe) & (LIMIT_SEEN_SLOTS - 1)];
+        uint64_t expected = 0;
+        if (atomic_compare_exchange_strong(slot, &expected, key)) return false;
+        if (expected == key) return true;
+    }
+    return false;
+}
+
+// word is the product of the generators before `last`; the node's disk is word(disks[last])
+void WalkWord(LimitWalker* walker, const double complex word[4], int last, int depth) {
+    const KleinianGroup* group = walker->job->group;
+    walker->words++;
+    GeneralizedCircle disk;
+    TransformCircles(word, &group->disks[last], &disk, 1);
+    // a bounded disk is A > 0 with the form negative inside; anything else has no size yet
+    if (disk.A > 1e-12) {
+        double complex center = -disk.B / disk.A;
+        double radiusSquared = (creal(disk.B) * creal(disk.B) + cimag(disk.B) * cimag(disk.B)) / (disk.A * disk.A) - disk.C / disk.A;
+        double radius = sqrt(fmax(radiusSquared, 0.0)) * SCALE;
+        double x = ORIGIN_X + creal(center) * SCALE, y = ORIGIN_Y - cimag(center) * SCALE;
+        if (x + radius < 0.0 || x - radius >= SCREEN_WIDTH || y + radius < 0.0 || y - radius >= SCREEN_HEIGHT) return;
+        if (radius < 1.0 || depth >= walker->job->maxDepth) {
+            if (x >= 0.0 && x < SCREEN_WIDTH && y >= 0.0 && y < SCREEN_HEIGHT) {
+                walker->coverage[(int)y * SCREEN_WIDTH + (int)x] = 1;
+            }
+            return;
+        }
+        if (radius >= LIMIT_SEEN_RADIUS && SeenLimitDisk(walker->job, x, y, radius)) {
+            walker->duplicates++;
+            return;
+        }
+    } else if (fabs(disk.A) <= 1e-12) {
+        // a half-plane misses the convex screen exactly when every corner is outside it
+        bool visible = false;
+        for (int corner = 0; corner < 4 && !visible; corner++) {
+            double complex z = ScreenToComplex((Vector2){ (corner & 1) ? SCREEN_WIDTH : 0, (corner & 2) ? SCREEN_HEIGHT : 0 });
+            visible = 2.0 * creal(conj(disk.B) * z) + disk.C < 0.0;
+        }
+        if (!visible || depth >= walker->job->maxDepth) return;
+    } else if (depth >= walker->job->maxDepth) {
+        return;
+    }
+    double complex next[4];
+    MultiplyMatrices(word, group->m[last], next);
+    // reduced words only: never follow a generator with its inverse
+    int inverse = (last + group->count / 2) % group->count;
+    for (int g = 0; g < group->count; g++) {
+        if (g != inverse) WalkWord(walker, next, g, depth + 1);
+    }
+}
+
+void* LimitWorker(void* arg) {
+    LimitWalker* walker = (LimitWalker*)arg;
+    LimitJob* job = walker->job;
+    for (;;) {
+        int task = atomic_fetch_add(&job->nextTask, 1);
+        if (task >= job->taskCount) break;
+        WalkWord(walker, job->group->m[job->tasks[task][0]], job->tasks[task][1], 2);
+    }
+    return NULL;
+}
+
+#define LIMIT_GROUP_COUNT 3
+
+typedef struct {
+    KleinianGroup groups[LIMIT_GROUP_COUNT];
+    Color* pixels;
+    Texture2D texture;
+    int groupIndex;            // which example is shown, -1 when the view is off
+    int maxDepth;
+    long long words;
+    long long duplicates;
+    double milliseconds;
+    bool valid;
+} LimitSetView;
+
+LimitSetView limitView = { 0 };
+
+void InitLimitSetView() {
+    Image image = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLANK);
+    limitView.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    limitView.pixels = (Color*)malloc((size_t)SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Color));
+    limitView.groupIndex = -1;
+    limitView.maxDepth = 48;
+    limitView.groups[0] = ApollonianGroup();
+    limitView.groups[1] = SchottkyGroup();
+    limitView.groups[2] = ThreePairSchottkyGroup();
+}
+
+// walks the depth-two subtrees on one thread per core, then merges the pixel masks
+void RenderLimitSet(const KleinianGroup* group, int maxDepth) {
+    double startTime = GetTime();
+    int tasks[MAX_GENERATORS * MAX_GENERATORS][2];
+    int taskCount = 0;
+    for (int first = 0; first < group->count; first++) {
+        for (int second = 0; second < group->count; second++) {
+            if (second == (first + group->count / 2) % group->count) continue;
+            tasks[taskCount][0] = first;
+            tasks[taskCount][1] = second;
+            taskCount++;
+        }
+    }
+    LimitJob job = { group, tasks, taskCount, 0, maxDepth,
+                     (_Atomic uint64_t*)calloc(LIMIT_SEEN_SLOTS, sizeof(_Atomic uint64_t)) };
+    
+    int threadCount = WorkerCount();
+    size_t pixelCount = (size_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+    LimitWalker walkers[MAX_WORKER_THREADS];
+    for (int i = 0; i < threadCount; i++) {
+        walkers[i] = (LimitWalker){ &job, (unsigned char*)calloc(pixelCount, 1), 0, 0 };
+        if (walkers[i].coverage == NULL) threadCount = i;
+    }
+    RunWorkers(LimitWorker, walkers, sizeof(LimitWalker), threadCount);
+    
+    limitView.words = 0;
+    limitView.duplicates = 0;
+    for (size_t p = 0; p < pixelCount; p++) limitView.pixels[p] = BLANK;
+    for (int i = 0; i < threadCount; i++) {
+        for (size_t p = 0; p < pixelCount; p++) {
+            if (walkers[i].coverage[p]) limitView.pixels[p] = DARKBLUE;
+        }
+        limitView.words += walkers[i].words;
+        limitView.duplicates += walkers[i].duplicates;
+        free(walkers[i].coverage);
+    }
+    free(job.seen);
+    UpdateTexture(limitView.texture, limitView.pixels);
+    limitView.milliseconds = (GetTime() - startTime) * 1000.0;
+}
+
+void DrawLimitSetView() {
+    const KleinianGroup* group = &limitView.groups[limitView.groupIndex];
+    if (!limitView.valid) {
+        RenderLimitSet(group, limitView.maxDepth);
+        limitView.valid = true;
+    }
+    DrawLine(0, ORIGIN_Y, SCREEN_WIDTH, ORIGIN_Y, LIGHTGRAY);
+    DrawLine(ORIGIN_X, 0, ORIGIN_X, SCREEN_HEIGHT, LIGHTGRAY);
+    for (int g = 0; g < group->count; g++) {
+        DrawGeneralizedCircle(group->disks[g], ColorAlpha(GRAY, 0.4f));
+    }
+    DrawTexture(limitView.texture, 0, 0, WHITE);
+    
+    DrawText(TextFormat("Limit set: %s", group->name), 10, 10, 20, DARKGRAY);
+    DrawText(TextFormat("%lld reduced words (%lld repeats skipped), depth cap %d (-/=), %.0f ms",
+                        limitView.words, limitView.duplicates, limitView.maxDepth, limitView.milliseconds),
+             10, 40, 15, DARKGRAY);
+    for (int g = 0; g < group->count / 2; g++) {
+        const double complex* m = group->m[g];
+        DrawText(TextFormat("g%d: a = %.2f%+.2fi  b = %.2f%+.2fi  c = %.2f%+.2fi  d = %.2f%+.2fi", g + 1,
+                            creal(m[0]), cimag(m[0]), creal(m[1]), cimag(m[1]), creal(m[2]), cimag(m[2]), creal(m[3]), cimag(m[3])),
+                 10, SCREEN_HEIGHT - 30 - 20 * (group->count / 2 - 1 - g), 15, DARKGRAY);
+    }
+    DrawText("K - Next Group / Exit", 10, 60, 15, DARKGRAY);
+}
+
+void UnloadLimitSetView() {
+    UnloadTexture(limitView.texture);
+    free(limitView.pixels);
+    limitView = (LimitSetView){ 0 };
+}
+
+// {p,q} tilings of the poincare disk: the central p-gon has its vertices where q meet, and
+// every other tile is its image under a word in the half-turns about the central edge
+// midpoints, found breadth first and deduplicated by a hash on the tile centres
+#define TILING_RADIUS 280.0
+#define TILING_SYMBOL_COUNT 5
+#define MAX_TILE_SIDES 12
+#define MAX_TILES (1 << 17)
+#define TILE_HASH_SIZE (1 << 18)
+#define TILE_MIN_PIXELS 0.5
+#define TILE_GRAPH_PIXELS 0.02      // the graph runs past the drawing cutoff so pans have tiles to bring in
+#define TILE_CENTER_QUANTUM 1e-6
+
+typedef struct {
+    double complex m[4];        // maps the central polygon onto this tile, determinant one
+    unsigned short edges;       // sides this tile draws; a shared side belongs to the lower index
+} Tile;
+
+typedef struct {
+    int symbols[TILING_SYMBOL_COUNT][2];
+    int symbolIndex;            // which {p,q} is shown, -1 when the view is off
+    int p, q;
+    double complex vertices[MAX_TILE_SIDES];
+    GeneralizedCircle sides[MAX_TILE_SIDES];          // side k joins vertices k and k + 1
+    double complex halfTurns[MAX_TILE_SIDES][4];
+    Tile* tiles;
+    int tileCount;
+    int* slots;                 // open-addressed tile indices, -1 when empty
+    double complex pan[4];      // disk automorphism applied at draw time only
+    Vector2 dragStart;
+    bool dragging;
+    bool built;
+    double milliseconds;
+} TilingView;
+
+TilingView tilingView = { 0 };
+
+Vector2 DiskToScreen(double complex z) {
+    return (Vector2){ ORIGIN_X + creal(z) * TILING_RADIUS, ORIGIN_Y - cimag(z) * TILING_RADIUS };
+}
+
+double complex ScreenToDisk(Vector2 pos) {
+    return ((pos.x - ORIGIN_X) / TILING_RADIUS) + ((ORIGIN_Y - pos.y) / TILING_RADIUS) * I;
+}
+
+// the rotation by pi about m: conjugate z -> -z by z -> (z + m)/(1 + conj(m) z)
+void HalfTurn(double complex m, double complex out[4]) {
+    double n = creal(m) * creal(m) + cimag(m) * cimag(m);
+    double complex scale = I * (1.0 - n);
+    out[0] = -(1.0 + n) / scale;
+    out[1] = 2.0 * m / scale;
+    out[2] = -2.0 * conj(m) / scale;
+    out[3] = (1.0 + n) / scale;
+}
+
+unsigned int TileCell(long long x, long long y) {
+    unsigned long long h = (unsigned long long)x * 0x9E3779B97F4A7C15ull ^ (unsigned long long)y * 0xC2B2AE3D27D4EB4Full;
+    return (unsigned int)(h >> 40) & (TILE_HASH_SIZE - 1);
+}
+
+// probes the cell of z and its neighbours across the nearest cell edges, so two centres that
+// round differently are still found
+int FindTile(double complex z) {
+    double fx = creal(z) / TILE_CENTER_QUANTUM, fy = cimag(z) / TILE_CENTER_QUANTUM;
+    long long x = (long long)floor(fx), y = (long long)floor(fy);
+    long long xs[2] = { x, fx - x < 0.5 ? x - 1 : x + 1 }, ys[2] = { y, fy - y < 0.5 ? y - 1 : y + 1 };
+    for (int k = 0; k < 4; k++) {
+        for (unsigned int slot = TileCell(xs[k & 1], ys[k >> 1]);; slot = (slot + 1) & (TILE_HASH_SIZE - 1)) {
+            int index = tilingView.slots[slot];
+            if (index < 0) break;
+            const double complex* m = tilingView.tiles[index].m;
+            if (cabs(m[1] / m[3] - z) < 0.1 * TILE_CENTER_QUANTUM) return index;
+        }
+    }
+    return -1;
+}
+
+void InsertTile(double complex z, int index) {
+    unsigned int slot = TileCell((long long)floor(creal(z) / TILE_CENTER_QUANTUM), (long long)floor(cimag(z) / TILE_CENTER_QUANTUM));
+    while (tilingView.slots[slot] >= 0) slot = (slot + 1) & (TILE_HASH_SIZE - 1);
+    tilingView.slots[slot] = index;
+}
+
+void InitTilingView() {
+    int symbols[TILING_SYMBOL_COUNT][2] = { { 7, 3 }, { 5, 4 }, { 4, 5 }, { 8, 3 }, { 3, 8 } };
+    for (int s = 0; s < TILING_SYMBOL_COUNT; s++) {
+        tilingView.symbols[s][0] = symbols[s][0];
+        tilingView.symbols[s][1] = symbols[s][1];
+    }
+    tilingView.tiles = (Tile*)malloc(MAX_TILES * sizeof(Tile));
+    tilingView.slots = (int*)malloc(TILE_HASH_SIZE * sizeof(int));
+    tilingView.symbolIndex = -1;
+    tilingView.pan[0] = tilingView.pan[3] = 1.0;
+}
+
+// rebuilds the tile graph for the current symbol; the pan never touches it
+void BuildTiling() {
+    double startTime = GetTime();
+    int p = tilingView.symbols[tilingView.symbolIndex][0], q = tilingView.symbols[tilingView.symbolIndex][1];
+    tilingView.p = p;
+    tilingView.q = q;
+    tilingView.tileCount = 0;
+    tilingView.built = true;
+    if (tilingView.tiles == NULL || tilingView.slots == NULL) return;
+    
+    // euclidean radius of the vertices, then the geodesic through two neighbours, which is
+    // the circle centred on their bisector that meets the unit circle at right angles
+    double radius = sqrt(cos(M_PI / p + M_PI / q) / cos(M_PI / p - M_PI / q));
+    double centerDistance = (radius * radius + 1.0) / (2.0 * radius * cos(M_PI / p));
+    double sideRadius = sqrt(centerDistance * centerDistance - 1.0);
+    for (int k = 0; k < p; k++) {
+        tilingView.vertices[k] = radius * cexp(2.0 * M_PI * I * k / p);
+        double complex bisector = cexp(M_PI * I * (2 * k + 1) / p);
+        tilingView.sides[k] = CircleFromCenter(centerDistance * bisector, sideRadius);
+        HalfTurn((centerDistance - sideRadius) * bisector, tilingView.halfTurns[k]);
+    }
+    
+    for (int i = 0; i < TILE_HASH_SIZE; i++) tilingView.slots[i] = -1;
+    tilingView.tiles[0] = (Tile){ { 1.0, 0.0, 0.0, 1.0 }, 0 };
+    InsertTile(0.0, 0);
+    tilingView.tileCount = 1;
+    for (int i = 0; i < tilingView.tileCount; i++) {
+        Tile* tile = &tilingView.tiles[i];
+        for (int k = 0; k < p; k++) {
+            // a half-turn about side k swaps its ends, so the neighbour shares its own side k
+            double complex next[4];
+            MultiplyMatrices(tile->m, tilingView.halfTurns[k], next);
+            double complex root = csqrt(next[0] * next[3] - next[1] * next[2]);
+            for (int e = 0; e < 4; e++) next[e] /= root;
+            double complex center = next[1] / next[3];
+            int j = FindTile(center);
+            if (j < 0 && tilingView.tileCount < MAX_TILES) {
+                double complex corner;
+                ApplyMobiusBatch(next, &tilingView.vertices[0], &corner, 1);
+                if (cabs(corner - center) * TILING_RADIUS >= TILE_GRAPH_PIXELS) {
+                    j = tilingView.tileCount++;
+                    tilingView.tiles[j] = (Tile){ { next[0], next[1], next[2], next[3] }, 0 };
+                    InsertTile(center, j);
+                    tile = &tilingView.tiles[i];
+                }
+            }
+            if (j < 0 || j > i) tile->edges |= (unsigned short)(1u << k);
+        }
+    }
+    tilingView.milliseconds = (GetTime() - startTime) * 1000.0;
+}
+
+// drags move the grabbed point along the disk automorphism taking it to the cursor
+void UpdateTilingPan() {
+    if (IsKeyPressed(KEY_R)) {
+        tilingView.pan[0] = tilingView.pan[3] = 1.0;
+        tilingView.pan[1] = tilingView.pan[2] = 0.0;
+    }
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && cabs(ScreenToDisk(mouse)) < 1.0) {
+        tilingView.dragging = true;
+        tilingView.dragStart = mouse;
+    }
+    if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) tilingView.dragging = false;
+    if (!tilingView.dragging) return;
+    // both ends stay inside the disk, where the maps below are automorphisms of it
+    double complex from = ScreenToDisk(tilingView.dragStart), to = ScreenToDisk(mouse);
+    if (cabs(from) > 0.995) from *= 0.995 / cabs(from);
+    if (cabs(to) > 0.995) to *= 0.995 / cabs(to);
+    if (cabs(from - to) < 1e-9) return;
+    // z -> (z + to)/(1 + conj(to) z) after z -> (z - from)/(1 - conj(from) z)
+    double complex toOrigin[4] = { 1.0, -from, -conj(from), 1.0 }, fromOrigin[4] = { 1.0, to, conj(to), 1.0 };
+    double complex move[4];
+    MultiplyMatrices(fromOrigin, toOrigin, move);
+    MultiplyMatrices(move, tilingView.pan, tilingView.pan);
+    double complex root = csqrt(tilingView.pan[0] * tilingView.pan[3] - tilingView.pan[1] * tilingView.pan[2]);
+    for (int e = 0; e < 4; e++) tilingView.pan[e] /= root;
+    tilingView.dragStart = DiskToScreen(to);
+}
+
+// a side is an arc of the image of its geodesic circle, run from one end to the other
+// through the inside of the disk
+void DrawGeodesicArc(GeneralizedCircle g, double complex from, double complex to, Color color) {
+    Vector2 start = DiskToScreen(from), end = DiskToScreen(to);
+    double chord = hypot(end.x - start.x, end.y - start.y);
+    if (fabs(g.A) < 1e-9 * cabs(g.B) || chord < 3.0) {
+        DrawLineV(start, end, color);
+        return;
+    }
+    double complex center = -g.B / g.A;
+    double radius = cabs(from - center);
+    double begin = carg(from - center);
+    double span = remainder(carg(to - center) - begin, 2.0 * M_PI);
+    int segments = (int)ceil(fabs(span) * radius * TILING_RADIUS / 4.0);
+    if (segments < 1) segments = 1;
+    if (segments > 64) segments = 64;
+    Vector2 previous = start;
+    for (int s = 1; s <= segments; s++) {
+        Vector2 next = s == segments ? end : DiskToScreen(center + radius * cexp(I * (begin + span * s / segments)));
+        DrawLineV(previous, next, color);
+        previous = next;
+    }
+}
+
+void DrawTilingView() {
+    if (!tilingView.built) BuildTiling();
+    int p = tilingView.p;
+    DrawCircle(ORIGIN_X, ORIGIN_Y, TILING_RADIUS, ColorAlpha(SKYBLUE, 0.15f));
+    DrawCircleLines(ORIGIN_X, ORIGIN_Y, TILING_RADIUS, DARKGRAY);
+    
+    int drawn = 0;
+    for (int i = 0; i < tilingView.tileCount; i++) {
+        const Tile* tile = &tilingView.tiles[i];
+        double complex m[4], corners[MAX_TILE_SIDES + 1];
+        MultiplyMatrices(tilingView.pan, tile->m, m);
+        double complex center = m[1] / m[3];
+        ApplyMobiusBatch(m, tilingView.vertices, corners, p);
+        if (cabs(corners[0] - center) * TILING_RADIUS < TILE_MIN_PIXELS) continue;
+        corners[p] = corners[0];
+        GeneralizedCircle sides[MAX_TILE_SIDES];
+        TransformCircles(m, tilingView.sides, sides, p);
+        for (int k = 0; k < p; k++) {
+            if (tile->edges & (1u << k)) DrawGeodesicArc(sides[k], corners[k], corners[k + 1], DARKBLUE);
+        }
+        drawn++;
+    }
+    
+    DrawText(TextFormat("Hyperbolic tiling {%d,%d}", tilingView.p, tilingView.q), 10, 10, 20, DARKGRAY);
+    DrawText(TextFormat("%d tiles in the graph, %d drawn, built in %.0f ms", tilingView.tileCount, drawn, tilingView.milliseconds),
+             10, 40, 15, DARKGRAY);
+    const double complex* m = tilingView.pan;
+    DrawText(TextFormat("pan: a = %.2f%+.2fi  b = %.2f%+.2fi  c = %.2f%+.2fi  d = %.2f%+.2fi",
+                        creal(m[0]), cimag(m[0]), creal(m[1]), cimag(m[1]), creal(m[2]), cimag(m[2]), creal(m[3]), cimag(m[3])),
+             10, SCREEN_HEIGHT - 30, 15, DARKGRAY);
+    DrawText("T - Next Tiling / Exit, Drag - Pan, R - Recenter", 10, 60, 15, DARKGRAY);
+}
+
+void UnloadTilingView() {
+    free(tilingView.tiles);
+    free(tilingView.slots);
+    tilingView = (TilingView){ 0 };
+}
+
+// apollonian packings by the complex descartes theorem: a circle is its signed curvature k
+// and k times its centre, and the circle across from `old` in the gap left by three mutually
+// tangent circles is twice their sum minus `old`, in both parts at once
+#define GASKET_MIN_PIXELS 0.5
+#define GASKET_MAX_DEPTH 2048
+
+typedef struct {
+    double k;
+    double complex kz;
+} DescartesCircle;
+
+typedef struct {
+    GeneralizedCircle* circles;    // images of the circles generated for the current view
+    int count;
+    int capacity;
+    double complex center;         // plane point at the middle of the screen
+    double zoom;                   // pixels per unit
+    double complex builtFor[4];    // transform, centre and zoom the circles were generated for
+    double complex builtCenter;
+    double builtZoom;
+    Vector2 dragStart;
+    bool dragging;
+    bool pushThrough;              // map the packing through a, b, c, d
+    bool active;
+    bool valid;
+    long long gaps;
+    double milliseconds;
+} GasketView;
+
+GasketView gasketView = { 0 };
+
+Vector2 GasketToScreen(double complex z) {
+    return (Vector2){ ORIGIN_X + (creal(z) - creal(gasketView.center)) * gasketView.zoom,
+                      ORIGIN_Y - (cimag(z) - cimag(gasketView.center)) * gasketView.zoom };
+}
+
+double complex ScreenToGasket(Vector2 pos) {
+    return gasketView.center + ((pos.x - ORIGIN_X) + (ORIGIN_Y - pos.y) * I) / gasketView.zoom;
+}
+
+void InitGasketView() {
+    gasketView.capacity = 4096;
+    gasketView.circles = (GeneralizedCircle*)malloc(gasketView.capacity * sizeof(GeneralizedCircle));
+    gasketView.zoom = 250.0;
+}
+
+void EmitGasketCircle(const double complex m[4], DescartesCircle circle) {
+    if (gasketView.count == gasketView.capacity) {
+        GeneralizedCircle* grown = (GeneralizedCircle*)realloc(gasketView.circles, 2 * gasketView.capacity * sizeof(GeneralizedCircle));
+        if (grown == NULL) return;
+        gasketView.circles = grown;
+        gasketView.capacity *= 2;
+    }
+    GeneralizedCircle source = CircleFromCenter(circle.kz / circle.k, 1.0 / fabs(circle.k));
+    TransformCircles(m, &source, &gasketView.circles[gasketView.count++], 1);
+}
+
+// the circle through the three tangency points meets all three circles at right angles, so
+// it encloses the whole gap between them and everything later packed into it
+GeneralizedCircle DualCircle(DescartesCircle c1, DescartesCircle c2, DescartesCircle c3) {
+    double complex p[3] = {
+        (c1.kz + c2.kz) / (c1.k + c2.k), (c2.kz + c3.kz) / (c2.k + c3.k), (c3.kz + c1.kz) / (c3.k + c1.k)
+    };
+    double x[3], y[3], n[3];
+    for (int i = 0; i < 3; i++) {
+        x[i] = creal(p[i]);
+        y[i] = cimag(p[i]);
+        n[i] = x[i] * x[i] + y[i] * y[i];
+    }
+    double det = 2.0 * (x[0] * (y[1] - y[2]) + x[1] * (y[2] - y[0]) + x[2] * (y[0] - y[1]));
+    double complex center = (n[0] * (y[1] - y[2]) + n[1] * (y[2] - y[0]) + n[2] * (y[0] - y[1])) / det +
+                            (n[0] * (x[2] - x[1]) + n[1] * (x[0] - x[2]) + n[2] * (x[1] - x[0])) / det * I;
+    return CircleFromCenter(center, cabs(p[0] - center));
+}
+
+// a gap is worth descending into while the image of its dual disk is on screen and at
+// least half a pixel across; a dual disk holding the pole maps to an outside and is kept
+bool GasketGapVisible(const double complex m[4], GeneralizedCircle dual, int depth) {
+    if (depth >= GASKET_MAX_DEPTH) return false;
+    if (cabs(m[2]) > 1e-15) {
+        double complex pole = -m[3] / m[2];
+        if (dual.A * (creal(pole) * creal(pole) + cimag(pole) * cimag(pole)) + 2.0 * creal(conj(dual.B) * pole) + dual.C < 0.0) {
+            return true;
+        }
+    }
+    GeneralizedCircle image;
+    TransformCircles(m, &dual, &image, 1);
+    if (fabs(image.A) <= 1e-12) return true;
+    double complex center = -image.B / image.A;
+    double radius = sqrt(fmax((creal(image.B) * creal(image.B) + cimag(image.B) * cimag(image.B)) / (image.A * image.A) - image.C / image.A, 0.0));
+    radius *= gasketView.zoom;
+    if (radius < GASKET_MIN_PIXELS) return false;
+    Vector2 p = GasketToScreen(center);
+    return p.x + radius >= 0.0 && p.x - radius < SCREEN_WIDTH && p.y + radius >= 0.0 && p.y - radius < SCREEN_HEIGHT;
+}
+
+void GasketDescend(const double complex m[4], DescartesCircle c1, DescartesCircle c2, DescartesCircle c3, DescartesCircle old, int depth) {
+    gasketView.gaps++;
+    if (!GasketGapVisible(m, DualCircle(c1, c2, c3), depth)) return;
+    DescartesCircle next = { 2.0 * (c1.k + c2.k + c3.k) - old.k, 2.0 * (c1.kz + c2.kz + c3.kz) - old.kz };
+    EmitGasketCircle(m, next);
+    GasketDescend(m, c1, c2, next, c3, depth + 1);
+    GasketDescend(m, c1, c3, next, c2, depth + 1);
+    GasketDescend(m, c2, c3, next, c1, depth + 1);
+}
+
+// regenerates only when the transform or the view moved
+void UpdateGasket() {
+    double complex m[4] = { 1.0, 0.0, 0.0, 1.0 };
+    if (gasketView.pushThrough) {
+        m[0] = a;
+        m[1] = b;
+        m[2] = c;
+        m[3] = d;
+    }
+    if (gasketView.valid && gasketView.builtCenter == gasketView.center && gasketView.builtZoom == gasketView.zoom &&
+        gasketView.builtFor[0] == m[0] && gasketView.builtFor[1] == m[1] && gasketView.builtFor[2] == m[2] && gasketView.builtFor[3] == m[3]) {
+        return;
+    }
+    double startTime = GetTime();
+    for (int i = 0; i < 4; i++) gasketView.builtFor[i] = m[i];
+    gasketView.builtCenter = gasketView.center;
+    gasketView.builtZoom = gasketView.zoom;
+    gasketView.valid = true;
+    gasketView.count = 0;
+    gasketView.gaps = 0;
+    if (gasketView.circles == NULL) return;
+    
+    // the (-1, 2, 2, 3, 3) packing: the unit circle, two halves and the two circles above and below
+    DescartesCircle outer = { -1.0, 0.0 }, left = { 2.0, -1.0 }, right = { 2.0, 1.0 };
+    DescartesCircle top = { 3.0, 2.0*I }, bottom = { 3.0, -2.0*I };
+    EmitGasketCircle(m, outer);
+    EmitGasketCircle(m, left);
+    EmitGasketCircle(m, right);
+    EmitGasketCircle(m, top);
+    EmitGasketCircle(m, bottom);
+    // every gap left by the five touches top or bottom
+    DescartesCircle caps[2] = { top, bottom };
+    for (int s = 0; s < 2; s++) {
+        GasketDescend(m, outer, left, caps[s], right, 1);
+        GasketDescend(m, outer, right, caps[s], left, 1);
+        GasketDescend(m, left, right, caps[s], outer, 1);
+    }
+    gasketView.milliseconds = (GetTime() - startTime) * 1000.0;
+}
+
+// every circle goes into one batch of line segments; lines through the pole are clipped
+// separately after it
+void DrawGasket() {
+    UpdateGasket();
+    rlBegin(RL_LINES);
+    rlColor4ub(DARKBLUE.r, DARKBLUE.g, DARKBLUE.b, DARKBLUE.a);
+    for (int i = 0; i < gasketView.count; i++) {
+        GeneralizedCircle g = gasketView.circles[i];
+        if (fabs(g.A) <= 1e-12) continue;
+        double complex center = -g.B / g.A;
+        double radius = sqrt(fmax((creal(g.B) * creal(g.B) + cimag(g.B) * cimag(g.B)) / (g.A * g.A) - g.C / g.A, 0.0)) * gasketView.zoom;
+        if (radius < GASKET_MIN_PIXELS) continue;
+        Vector2 p = GasketToScreen(center);
+        double start, span;
+        if (!VisibleArc(p.x, p.y, radius, &start, &span)) continue;
+        double step = radius > 0.5 ? 2.0 * acos(1.0 - 0.5 / radius) : span;
+        int segments = (int)ceil(span / step);
+        if (segments < 6) segments = 6;
+        if (segments > 1024) segments = 1024;
+        double x = p.x + radius * cos(start), y = p.y + radius * sin(start);
+        for (int k = 1; k <= segments; k++) {
+            double angle = start + span * k / segments;
+            double nx = p.x + radius * cos(angle), ny = p.y + radius * sin(angle);
+            rlCheckRenderBatchLimit(2);
+            rlVertex2f((float)x, (float)y);
+            rlVertex2f((float)nx, (float)ny);
+            x = nx;
+            y = ny;
+        }
+    }
+    rlEnd();
+    for (int i = 0; i < gasketView.count; i++) {
+        GeneralizedCircle g = gasketView.circles[i];
+        if (fabs(g.A) > 1e-12 || cabs(g.B) < 1e-12) continue;
+        double complex foot = -g.C * g.B / (2.0 * (creal(g.B) * creal(g.B) + cimag(g.B) * cimag(g.B)));
+        double complex along = I * g.B / cabs(g.B);
+        DrawClippedLine(GasketToScreen(foot), (Vector2){ creal(along), -cimag(along) }, DARKBLUE);
+    }
+}
+
+// wheel zooms about the cursor, dragging pans
+void UpdateGasketView() {
+    Vector2 mouse = GetMousePosition();
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        double complex anchor = ScreenToGasket(mouse);
+        double factor = pow(1.25, wheel);
+        gasketView.zoom *= factor;
+        gasketView.center = anchor + (gasketView.center - anchor) / factor;
+    }
+    if (IsKeyPressed(KEY_R)) {
+        gasketView.center = 0.0;
+        gasketView.zoom = 250.0;
+    }
+    if (IsKeyPressed(KEY_M)) gasketView.pushThrough = !gasketView.pushThrough;
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        gasketView.dragging = true;
+        gasketView.dragStart = mouse;
+    }
+    if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON)) gasketView.dragging = false;
+    if (gasketView.dragging) {
+        gasketView.center -= ((mouse.x - gasketView.dragStart.x) - (mouse.y - gasketView.dragStart.y) * I) / gasketView.zoom;
+        gasketView.dragStart = mouse;
+    }
+}
+
+void DrawGasketView() {
+    DrawGasket();
+    DrawText(gasketView.pushThrough ? "Apollonian gasket through w = (az + b)/(cz + d)" : "Apollonian gasket", 10, 10, 20, DARKGRAY);
+    DrawText(TextFormat("%d circles from %lld gaps, %.1f ms, zoom %.3g", gasketView.count, gasketView.gaps, gasketView.milliseconds, gasketView.zoom / 250.0),
+             10, 40, 15, DARKGRAY);
+    DrawText("G - Exit, M - Map Through Transform, Up/Down - Transform, Wheel/Drag - Zoom/Pan, R - Reset", 10, 60, 15, DARKGRAY);
+}
+
+void UnloadGasketView() {
+    free(gasketView.circles);
+    gasketView = (GasketView){ 0 };
+}
+
+// any image as the source plane, shown through the current map: every output pixel pulls
+// back through z = (dw - b)/(a - cw) and samples the source bilinearly or bicubically;
+// re-rendered only when the coefficients, the view or the source change
+#define WARP_SOURCE_UNITS 4.0       // plane units spanned by the longer side of the source
+
+typedef struct {
+    Color* source;
+    int sourceWidth;
+    int sourceHeight;
+    Color* pixels;
+    Texture2D texture;
+    double complex center;          // plane point at the middle of the screen
+    double zoom;                    // pixels per unit
+    double complex builtFor[4];
+    double complex builtCenter;
+    double builtZoom;
+    bool bicubic;
+    bool active;
+    bool valid;
+    double milliseconds;
+} WarpView;
+
+WarpView warpView = { 0 };
+
+typedef struct {
+    int firstRow;
+    int lastRow;
+    double complex m[4];
+} WarpBand;
+
+// the built-in source: a hue wheel under a checkerboard, so orientation and scale both show
+void MakeDefaultWarpSource() {
+    int size = 512;
+    Color* source = (Color*)malloc((size_t)size * size * sizeof(Color));
+    if (source == NULL) return;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            double u = x - size / 2 + 0.5, v = size / 2 - y - 0.5;
+            float hue = (float)(atan2(v, u) * 180.0 / PI + 180.0);
+            float value = ((x / 32 + y / 32) & 1) ? 0.95f : 0.7f;
+            source[(size_t)y * size + x] = ColorFromHSV(hue, 0.6f, value);
+        }
+    }
+    free(warpView.source);
+    warpView.source = source;
+    warpView.sourceWidth = size;
+    warpView.sourceHeight = size;
+    warpView.valid = false;
+}
+
+void LoadWarpSource(const char* path) {
+    Image image = LoadImage(path);
+    if (image.data == NULL) return;
+    Color* colors = LoadImageColors(image);
+    size_t count = (size_t)image.width * image.height;
+    Color* source = colors == NULL ? NULL : (Color*)malloc(count * sizeof(Color));
+    if (source != NULL) {
+        for (size_t i = 0; i < count; i++) source[i] = colors[i];
+        free(warpView.source);
+        warpView.source = source;
+        warpView.sourceWidth = image.width;
+        warpView.sourceHeight = image.height;
+        warpView.valid = false;
+    }
+    if (colors != NULL) UnloadImageColors(colors);
+    UnloadImage(image);
+}
+
+void InitWarpView() {
+    Image image = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLANK);
+    warpView.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    warpView.pixels = (Color*)malloc((size_t)SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(Color));
+    warpView.zoom = 100.0;
+    MakeDefaultWarpSource();
+}
+
+// catmull-rom weights for the four taps around a fractional offset t
+void CubicWeights(float t, float w[4]) {
+    float t2 = t * t, t3 = t2 * t;
+    w[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+    w[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    w[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    w[3] = 0.5f * (t3 - t2);
+}
+
+static inline unsigned char ClampChannel(float value) {
+    value += 0.5f;
+    return (unsigned char)(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value));
+}
+
+// (u, v) in source pixels; taps past the edge are clamped, points past it are blank
+Color SampleBilinear(const Color* source, int width, int height, float u, float v) {
+    if (!(u >= -0.5f && u < width - 0.5f && v >= -0.5f && v < height - 0.5f)) return BLANK;
+    float x = floorf(u), y = floorf(v);
+    float fx = u - x, fy = v - y;
+    int x0 = (int)x, y0 = (int)y;
+    int x1 = x0 + 1 < width ? x0 + 1 : width - 1, y1 = y0 + 1 < height ? y0 + 1 : height - 1;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    const Color* top = source + (size_t)y0 * width;
+    const Color* bottom = source + (size_t)y1 * width;
+    float w00 = (1.0f - fx) * (1.0f - fy), w10 = fx * (1.0f - fy), w01 = (1.0f - fx) * fy, w11 = fx * fy;
+    return (Color){
+        ClampChannel(w00 * top[x0].r + w10 * top[x1].r + w01 * bottom[x0].r + w11 * bottom[x1].r),
+        ClampChannel(w00 * top[x0].g + w10 * top[x1].g + w01 * bottom[x0].g + w11 * bottom[x1].g),
+        ClampChannel(w00 * top[x0].b + w10 * top[x1].b + w01 * bottom[x0].b + w11 * bottom[x1].b),
+        ClampChannel(w00 * top[x0].a + w10 * top[x1].a + w01 * bottom[x0].a + w11 * bottom[x1].a)
+    };
+}
+
+Color SampleBicubic(const Color* source, int width, int height, float u, float v) {
+    if (!(u >= -0.5f && u < width - 0.5f && v >= -0.5f && v < height - 0.5f)) return BLANK;
+    float x = floorf(u), y = floorf(v);
+    int x0 = (int)x, y0 = (int)y;
+    float wx[4], wy[4];
+    CubicWeights(u - x, wx);
+    CubicWeights(v - y, wy);
+    int columns[4];
+    for (int i = 0; i < 4; i++) {
+        int sx = x0 - 1 + i;
+        columns[i] = sx < 0 ? 0 : (sx >= width ? width - 1 : sx);
+    }
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int j = 0; j < 4; j++) {
+        int sy = y0 - 1 + j;
+        sy = sy < 0 ? 0 : (sy >= height ? height - 1 : sy);
+        const Color* row = source + (size_t)sy * width;
+        float r = 0.0f, g = 0.0f, bl = 0.0f, al = 0.0f;
+        for (int i = 0; i < 4; i++) {
+            Color texel = row[columns[i]];
+            r += wx[i] * texel.r;
+            g += wx[i] * texel.g;
+            bl += wx[i] * texel.b;
+            al += wx[i] * texel.a;
+        }
+        sum[0] += wy[j] * r;
+        sum[1] += wy[j] * g;
+        sum[2] += wy[j] * bl;
+        sum[3] += wy[j] * al;
+    }
+    return (Color){ ClampChannel(sum[0]), ClampChannel(sum[1]), ClampChannel(sum[2]), ClampChannel(sum[3]) };
+}
+
+void* WarpRows(void* arg) {
+    WarpBand* band = (WarpBand*)arg;
+    const double complex* m = band->m;
+    double ar = creal(m[0]), ai = cimag(m[0]), br = creal(m[1]), bi = cimag(m[1]);
+    double cr = creal(m[2]), ci = cimag(m[2]), dr = creal(m[3]), di = cimag(m[3]);
+    // locals, so the stores into the output rows cannot force the view to be reloaded
+    const Color* source = warpView.source;
+    int width = warpView.sourceWidth, height = warpView.sourceHeight;
+    bool bicubic = warpView.bicubic;
+    double step = 1.0 / warpView.zoom;
+    double unitsPerPixel = WARP_SOURCE_UNITS / (width > height ? width : height);
+    double left = -0.5 * width * unitsPerPixel, top = 0.5 * height * unitsPerPixel;
+    for (int y = band->firstRow; y < band->lastRow; y++) {
+        Color* row = warpView.pixels + (size_t)y * SCREEN_WIDTH;
+        double wx = creal(warpView.center) + (0.5 - ORIGIN_X) * step;
+        double wy = cimag(warpView.center) + (ORIGIN_Y - y - 0.5) * step;
+        // numerator dw - b and denominator a - cw are affine along the row, so both advance by
+        // a constant; the quotient is taken in real arithmetic as N conj(D) / |D|^2
+        double nr = dr * wx - di * wy - br, ni = dr * wy + di * wx - bi;
+        double qr = ar - (cr * wx - ci * wy), qi = ai - (cr * wy + ci * wx);
+        double dnr = dr * step, dni = di * step, dqr = -cr * step, dqi = -ci * step;
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            double q2 = qr * qr + qi * qi;
+            double zr = (nr * qr + ni * qi) / q2, zi = (ni * qr - nr * qi) / q2;
+            float u = (float)((zr - left) / unitsPerPixel - 0.5), v = (float)((top - zi) / unitsPerPixel - 0.5);
+            row[x] = bicubic ? SampleBicubic(source, width, height, u, v) : SampleBilinear(source, width, height, u, v);
+            nr += dnr;
+            ni += dni;
+            qr += dqr;
+            qi += dqi;
+        }
+    }
+    return NULL;
+}
+
+void UpdateWarp() {
+    if (warpView.pixels == NULL || warpView.source == NULL) return;
+    double complex m[4] = { a, b, c, d };
+    if (warpView.valid && warpView.builtCenter == warpView.center && warpView.builtZoom == warpView.zoom &&
+        warpView.builtFor[0] == m[0] && warpView.builtFor[1] == m[1] && warpView.builtFor[2] == m[2] && warpView.builtFor[3] == m[3]) {
+        return;
+    }
+    double startTime = GetTime();
     
-    // avoid division by zero
-    if (cabs(denominator) < 1e-10) {
-        return 1e10 + 1e10*I;  // Return "infinity"
+    // one band of rows per core
+    int bandCount = WorkerCount();
+    WarpBand bands[MAX_WORKER_THREADS];
+    for (int i = 0; i < bandCount; i++) {
+        bands[i] = (WarpBand){ SCREEN_HEIGHT * i / bandCount, SCREEN_HEIGHT * (i + 1) / bandCount, { m[0], m[1], m[2], m[3] } };
     }
+    RunWorkers(WarpRows, bands, sizeof(WarpBand), bandCount);
     
-    return numerator / denominator;
+    UpdateTexture(warpView.texture, warpView.pixels);
+    for (int i = 0; i < 4; i++) warpView.builtFor[i] = m[i];
+    warpView.builtCenter = warpView.center;
+    warpView.builtZoom = warpView.zoom;
+    warpView.valid = true;
+    warpView.milliseconds = (GetTime() - startTime) * 1000.0;
+}
+
+// wheel zooms about the cursor, a dropped file becomes the source, B switches the filter
+void UpdateWarpView() {
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        Vector2 mouse = GetMousePosition();
+        double complex anchor = warpView.center + ((mouse.x - ORIGIN_X) + (ORIGIN_Y - mouse.y) * I) / warpView.zoom;
+        double factor = pow(1.25, wheel);
+        warpView.zoom *= factor;
+        warpView.center = anchor + (warpView.center - anchor) / factor;
+    }
+    if (IsKeyPressed(KEY_B)) {
+        warpView.bicubic = !warpView.bicubic;
+        warpView.valid = false;
+    }
+    if (IsFileDropped()) {
+        FilePathList files = LoadDroppedFiles();
+        if (files.count > 0) LoadWarpSource(files.paths[0]);
+        UnloadDroppedFiles(files);
+    }
+}
+
+void DrawWarpView() {
+    UpdateWarp();
+    DrawTexture(warpView.texture, 0, 0, WHITE);
+    DrawText("Image warp through w = (az + b)/(cz + d)", 10, 10, 20, DARKGRAY);
+    DrawText(TextFormat("%dx%d source, %s, %.1f ms", warpView.sourceWidth, warpView.sourceHeight,
+                        warpView.bicubic ? "bicubic" : "bilinear", warpView.milliseconds), 10, 40, 15, DARKGRAY);
+    DrawText("W - Exit, B - Filter, Drop an Image - Source, Up/Down - Transform, Wheel - Zoom", 10, 60, 15, DARKGRAY);
+}
+
+void UnloadWarpView() {
+    UnloadTexture(warpView.texture);
+    free(warpView.pixels);
+    free(warpView.source);
+    warpView = (WarpView){ 0 };
 }
 
 void DrawHorizontalLines() {
     DrawLine(0, ORIGIN_Y, SCREEN_WIDTH, ORIGIN_Y, DARKGRAY);
     DrawLine(ORIGIN_X, 0, ORIGIN_X, SCREEN_HEIGHT, DARKGRAY);
     
-    for (int i = -5; i <= 5; i++) {
+    UpdateImages();
+    for (int i = -5, k = 0; i <= 5; i++) {
         if (i == 0) continue;
         
         Color lineColor = BLUE;
@@ -98,21 +1743,13 @@ void DrawHorizontalLines() {
             DrawLineV(p1, p2, ColorAlpha(lineColor, 0.5f));
         }
         
-        if (currentTransform != TRANSFORM_IDENTITY) {
-            for (float x = -10.0f; x <= 10.0f; x += 0.1f) {
-                double complex z1 = x + i*I;
-                double complex z2 = (x + 0.1f) + i*I;
-                
-                double complex w1 = BilinearTransform(z1);
-                double complex w2 = BilinearTransform(z2);
-                
-                if (cabs(w1) < 100.0 && cabs(w2) < 100.0) {
-                    Vector2 p1 = ComplexToScreen(w1);
-                    Vector2 p2 = ComplexToScreen(w2);
-                    DrawLineV(p1, p2, RED);
-                }
-            }
+        if (currentTransform != TRANSFORM_IDENTITY && sampledImages) {
+            double complex m[4] = { a, b, c, d };
+            DrawMappedPolyline(m, sampledLines[k], SAMPLED_POINTS, RED);
+        } else if (currentTransform != TRANSFORM_IDENTITY) {
+            DrawGeneralizedCircle(imageLines[k], RED);
         }
+        k++;
     }
 }
 
@@ -128,105 +1765,226 @@ void DrawUnitCircle() {
     }
     
     if (currentTransform != TRANSFORM_IDENTITY) {
-        for (float theta = 0.0f; theta < 2.0f * PI; theta += 0.05f) {
-            double complex z1 = radius * cosf(theta) + radius * sinf(theta) * I;
-            double complex z2 = radius * cosf(theta + 0.05f) + radius * sinf(theta + 0.05f) * I;
-            
-            double complex w1 = BilinearTransform(z1);
-            double complex w2 = BilinearTransform(z2);
-            
-            if (cabs(w1) < 100.0 && cabs(w2) < 100.0) {
-                Vector2 p1 = ComplexToScreen(w1);
-                Vector2 p2 = ComplexToScreen(w2);
-                DrawLineV(p1, p2, RED);
-            }
+        if (currentTransform == TRANSFORM_CIRCLE_TO_HALFPLANE || currentTransform == TRANSFORM_CUSTOM) {
+            UpdateRegionFill();
+            DrawTexture(regionFill.texture, 0, 0, WHITE);
         }
         
-        if (currentTransform == TRANSFORM_CIRCLE_TO_HALFPLANE) {
-            int resolution = 30;
-            for (int i = -resolution; i <= resolution; i++) {
-                for (int j = -resolution; j <= resolution; j++) {
-                    float x = (float)i / resolution;
-                    float y = (float)j / resolution;
-                    
-                    float distSq = x*x + y*y;
-                    if (distSq <= 1.0f) {
-                        double complex z = x + y*I;
-                        double complex w = BilinearTransform(z);
-                        
-                        if (cabs(w) < 100.0) {
-                            Vector2 p = ComplexToScreen(w);
-                            DrawPixel(p.x, p.y, ColorAlpha(RED, 0.2f));
-                        }
-                    }
-                }
-            }
+        if (sampledImages) {
+            double complex m[4] = { a, b, c, d };
+            DrawMappedPolyline(m, sampledCircle, SAMPLED_POINTS + 1, RED);
+        } else {
+            UpdateImages();
+            DrawGeneralizedCircle(imageCircle, RED);
         }
     }
 }
 
+// everything on screen is a function of the state, so it is drawn once into the scene
+// texture and only redrawn after an input event or while the flow animates
+void DrawScene() {
+    if (warpView.active) {
+        DrawWarpView();
+        return;
+    }
+    if (gasketView.active) {
+        DrawGasketView();
+        return;
+    }
+    if (tilingView.symbolIndex >= 0) {
+        DrawTilingView();
+        return;
+    }
+    if (limitView.groupIndex >= 0) {
+        DrawLimitSetView();
+        return;
+    }
+    
+    if (currentInput == INPUT_LINES) {
+        DrawHorizontalLines();
+    } else {
+        DrawUnitCircle();
+    }
+    DrawFlowLines();
+    DrawHandles();
+    DrawFlowInfo();
+    
+    const char* inputText = (currentInput == INPUT_LINES) ? "Input: Horizontal Lines" : "Input: Unit Circle";
+    DrawText(inputText, 10, 10, 20, DARKGRAY);
+    
+    const char* transformText;
+    switch (currentTransform) {
+        case TRANSFORM_IDENTITY:
+            transformText = "Transform: Identity";
+            break;
+        case TRANSFORM_CIRCLE_AND_LINE_PRESERVING:
+            transformText = "Transform: Circle/Line Preserving";
+            break;
+        case TRANSFORM_CIRCLE_TO_HALFPLANE:
+            transformText = "Transform: Circle to Half-Plane";
+            break;
+        default:
+            transformText = "Transform: Custom";
+            break;
+    }
+    DrawText(transformText, 10, 40, 20, DARKGRAY);
+    
+    char formula[100];
+    sprintf(formula, "w = (%.1f%+.1fi)z + (%.1f%+.1fi)", creal(a), cimag(a), creal(b), cimag(b));
+    DrawText(formula, 10, SCREEN_HEIGHT - 60, 20, DARKGRAY);
+    
+    char formula2[100];
+    sprintf(formula2, "    (%.1f%+.1fi)z + (%.1f%+.1fi)", creal(c), cimag(c), creal(d), cimag(d));
+    DrawText(formula2, 10, SCREEN_HEIGHT - 30, 20, DARKGRAY);
+    
+    DrawLine(10, SCREEN_HEIGHT - 45, 300, SCREEN_HEIGHT - 45, DARKGRAY);
+    
+    DrawText("Controls: Left/Right - Change Input, Up/Down - Change Transform", 
+             10, SCREEN_HEIGHT - 90, 15, DARKGRAY);
+    const char* editText[EDIT_MODE_COUNT] = {
+        "E - Edit: off",
+        "E - Edit: drag the a, b, c, d handles",
+        "E - Edit: drag z1..z3 and their targets w1..w3"
+    };
+    DrawText(editText[editMode], 10, 70, 15, DARKGRAY);
+    DrawText(sampledImages ? "Space - Replay Flow, F - Flow Lines, S - Images: sampled" : "Space - Replay Flow, F - Flow Lines, S - Images: exact",
+             10, 90, 15, DARKGRAY);
+    DrawText("K - Kleinian Limit Sets, T - Tilings, G - Gasket, W - Image Warp", 10, 110, 15, DARKGRAY);
+}
+
 int main(void) {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Bilinear Mapping Visualizer");
     SetTargetFPS(60);
     
     UpdateTransformParameters();
+    InitInputFamilies();
+    InitRegionFill();
+    InitFlowSeeds();
+    InitLimitSetView();
+    InitTilingView();
+    InitGasketView();
+    InitWarpView();
+    SetFlowTarget(false);
+    RenderTexture2D scene = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+    bool sceneDrawn = false;
     
     while (!WindowShouldClose()) {
+        bool sceneDirty = !sceneDrawn || input_event_this_frame() || flow.animating;
+        
         if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_RIGHT)) {
             currentInput = (currentInput == INPUT_LINES) ? INPUT_CIRCLE : INPUT_LINES;
         }
         
         if (IsKeyPressed(KEY_UP)) {
-            currentTransform = (currentTransform + 1) % 3;
+            currentTransform = (currentTransform + 1) % TRANSFORM_COUNT;
             UpdateTransformParameters();
+            SetFlowTarget(true);
         }
         if (IsKeyPressed(KEY_DOWN)) {
-            currentTransform = (currentTransform + 2) % 3;
+            currentTransform = (currentTransform + TRANSFORM_COUNT - 1) % TRANSFORM_COUNT;
             UpdateTransformParameters();
+            SetFlowTarget(true);
         }
-        
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        
-        if (currentInput == INPUT_LINES) {
-            DrawHorizontalLines();
+        if (IsKeyPressed(KEY_E)) {
+            editMode = (editMode + 1) % EDIT_MODE_COUNT;
+            draggedHandle = -1;
+            if (editMode == EDIT_THREE_POINTS) {
+                // start from the map on screen, so switching modes does not jump
+                for (int k = 0; k < 3; k++) {
+                    targetPoints[k] = BilinearTransform(sourcePoints[k]);
+                }
+                if (!SolveThreePointMap()) {
+                    for (int k = 0; k < 3; k++) {
+                        targetPoints[k] = sourcePoints[k];
+                    }
+                    SolveThreePointMap();
+                }
+            }
+        }
+        if (IsKeyPressed(KEY_SPACE) && flow.valid) {
+            a = flow.target[0];
+            b = flow.target[1];
+            c = flow.target[2];
+            d = flow.target[3];
+            SetFlowTarget(true);
+        }
+        if (IsKeyPressed(KEY_F)) {
+            showFlowLines = !showFlowLines;
+        }
+        if (IsKeyPressed(KEY_S)) {
+            sampledImages = !sampledImages;
+        }
+        if (IsKeyPressed(KEY_K)) {
+            limitView.groupIndex = limitView.groupIndex + 1 < LIMIT_GROUP_COUNT ? limitView.groupIndex + 1 : -1;
+            limitView.valid = false;
+            tilingView.symbolIndex = -1;
+            gasketView.active = false;
+            warpView.active = false;
+        }
+        if (limitView.groupIndex >= 0 && IsKeyPressed(KEY_EQUAL) && limitView.maxDepth < 256) {
+            limitView.maxDepth *= 2;
+            limitView.valid = false;
+        }
+        if (limitView.groupIndex >= 0 && IsKeyPressed(KEY_MINUS) && limitView.maxDepth > 2) {
+            limitView.maxDepth /= 2;
+            limitView.valid = false;
+        }
+        if (IsKeyPressed(KEY_T)) {
+            tilingView.symbolIndex = tilingView.symbolIndex + 1 < TILING_SYMBOL_COUNT ? tilingView.symbolIndex + 1 : -1;
+            tilingView.built = false;
+            limitView.groupIndex = -1;
+            gasketView.active = false;
+            warpView.active = false;
+        }
+        if (IsKeyPressed(KEY_G)) {
+            gasketView.active = !gasketView.active;
+            tilingView.symbolIndex = -1;
+            limitView.groupIndex = -1;
+            warpView.active = false;
+        }
+        if (IsKeyPressed(KEY_W)) {
+            warpView.active = !warpView.active;
+            tilingView.symbolIndex = -1;
+            limitView.groupIndex = -1;
+            gasketView.active = false;
+        }
+        if (warpView.active) {
+            UpdateWarpView();
+        } else if (gasketView.active) {
+            UpdateGasketView();
+        } else if (tilingView.symbolIndex >= 0) {
+            UpdateTilingPan();
         } else {
-            DrawUnitCircle();
+            UpdateDragging();
         }
+        AdvanceFlow();
         
-        const char* inputText = (currentInput == INPUT_LINES) ? "Input: Horizontal Lines" : "Input: Unit Circle";
-        DrawText(inputText, 10, 10, 20, DARKGRAY);
-        
-        const char* transformText;
-        switch (currentTransform) {
-            case TRANSFORM_IDENTITY:
-                transformText = "Transform: Identity";
-                break;
-            case TRANSFORM_CIRCLE_AND_LINE_PRESERVING:
-                transformText = "Transform: Circle/Line Preserving";
-                break;
-            case TRANSFORM_CIRCLE_TO_HALFPLANE:
-                transformText = "Transform: Circle to Half-Plane";
-                break;
-        }
-        DrawText(transformText, 10, 40, 20, DARKGRAY);
-        
-        char formula[100];
-        sprintf(formula, "w = (%.1f%+.1fi)z + (%.1f%+.1fi)", creal(a), cimag(a), creal(b), cimag(b));
-        DrawText(formula, 10, SCREEN_HEIGHT - 60, 20, DARKGRAY);
-        
-        char formula2[100];
-        sprintf(formula2, "    (%.1f%+.1fi)z + (%.1f%+.1fi)", creal(c), cimag(c), creal(d), cimag(d));
-        DrawText(formula2, 10, SCREEN_HEIGHT - 30, 20, DARKGRAY);
-        
-        DrawLine(10, SCREEN_HEIGHT - 45, 300, SCREEN_HEIGHT - 45, DARKGRAY);
-        
-        DrawText("Controls: Left/Right - Change Input, Up/Down - Change Transform", 
-                 10, SCREEN_HEIGHT - 90, 15, DARKGRAY);
+        // poll while the flow runs, otherwise sleep in EndDrawing until the next event
+        if (flow.animating) {
+            DisableEventWaiting();
+        } else {
+            EnableEventWaiting();
+        }
+        if (sceneDirty) {
+            BeginTextureMode(scene);
+            ClearBackground(RAYWHITE);
+            DrawScene();
+            EndTextureMode();
+            sceneDrawn = true;
+        }
         
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        scene_texture_draw(scene);
         EndDrawing();
     }
     
+    UnloadRegionFill();
+    UnloadLimitSetView();
+    UnloadTilingView();
+    UnloadGasketView();
+    UnloadWarpView();
+    UnloadRenderTexture(scene);
     CloseWindow();
     
     return 0;
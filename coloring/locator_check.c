@@ -0,0 +1,58 @@
+// runs the zero and pole locator on views where every zero and pole is known and exits 0 when
+// it finds all of them: tan(z) zoomed out until a cell of LOCATOR_COARSE_CELL holds a
+// cancelling zero and pole, and the double zero of z^2 lying on a pixel row. it builds on the
+// app itself with its main renamed:
+//   cc coloring/locator_check.c -std=c11 -o bin/locator_check $(pkg-config --cflags --libs raylib)
+#define main coloring_main
+#include "main.c"
+#undef main
+
+static bool check_locator(void) {
+    struct { FunctionType type; double centerX, centerY, scale; } views[] = {
+        { FUNC_TAN, 0.0, 0.0, 13.0 }, { FUNC_TAN, 0.0, 0.0, 20.0 }, { FUNC_TAN, 0.0, 0.0, 30.0 },
+        { FUNC_TAN, 0.0, 0.0, 40.0 }, { FUNC_TAN, 1.1, 0.2, 16.0 }, { FUNC_SQUARE, 0.37, 0.0, 13.0 },
+        { FUNC_SQUARE, 0.37, 0.0, 60.0 },
+    };
+    ColoringParams params = { .line_thickness = 0.05f, .saturation = 0.9f, .value = 1.0f,
+                              .contrast_strength = 1.0f, .anti_aliasing = 1 };
+    StatusMessage status = { 0 };
+    Color* pixels = malloc(sizeof(Color) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    float* phases = malloc(sizeof(float) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    static ZeroPoleMap map;
+    static ResidueMap residues;
+    bool passed = pixels != NULL && phases != NULL;
+    for (int v = 0; passed && v < (int)(sizeof(views) / sizeof(views[0])); v++) {
+        double cx = views[v].centerX, cy = views[v].centerY, scale = views[v].scale;
+        render_domain_coloring(pixels, views[v].type, cx, cy, scale, params, &status, phases);
+        map = locate_zeros_and_poles(views[v].type, phases, cx, cy, scale, SCREEN_WIDTH, SCREEN_HEIGHT);
+        residues = compute_residues(&map, views[v].type, scale);
+        // tan has simple zeros at k pi and poles at k pi + pi/2, each pole with residue -1
+        double x0 = cx - (SCREEN_WIDTH/2) / scale, x1 = cx + (SCREEN_WIDTH/2 - 1) / scale;
+        double y0 = cy - (SCREEN_HEIGHT/2 - 1) / scale, y1 = cy + (SCREEN_HEIGHT/2) / scale;
+        int expected = 0, found = 0;
+        for (int k = -1000; k <= 1000 && y0 < 0.0 && y1 > 0.0; k++) {
+            double z = (views[v].type == FUNC_TAN) ? 0.5 * M_PI * k : 0.0;
+            if (z <= x0 || z >= x1 || (views[v].type == FUNC_SQUARE && k != 0)) continue;
+            int order = (views[v].type == FUNC_SQUARE) ? 2 : (k % 2 == 0 ? 1 : -1);
+            expected++;
+            for (int j = 0; j < map.count; j++) {
+                if (map.points[j].order == order && cabs(map.points[j].z - z) < 1e-9) found++;
+            }
+        }
+        double residue_error = 0.0;
+        for (int j = 0; j < residues.count; j++) {
+            residue_error = fmax(residue_error, cabs(residues.residues[j].principal[0] + 1.0));
+        }
+        bool ok = found == expected && map.count == expected && residue_error < 1e-9;
+        printf("%s %s at %g%+gi, scale %g: %d of %d zeros and poles, residue error %.1e\n", ok ? "ok  " : "FAIL",
+               function_names[views[v].type], cx, cy, scale, found, expected, residue_error);
+        passed = passed && ok;
+    }
+    free(pixels);
+    free(phases);
+    return passed;
+}
+
+int main(void) {
+    return check_locator() ? 0 : 1;
+}
@@ -1,8 +1,15 @@
 // domain coloring for complex functions; interactive controls for function, phase/modulus lines, and aa
 #include "raylib.h"
+#include "../common/overlay.h"
 #include "complex.h"
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 800
@@ -166,28 +173,79 @@ double complex evaluate_function(double complex z, FunctionType type, bool *erro
     }
 }
 
-bool render_domain_coloring(Color *pixels, FunctionType func_type, double centerX, double centerY, 
-                           double scale, ColoringParams params, StatusMessage *status) {
-    if (pixels == NULL) {
-        if (status) {
-            status->status = STATUS_RENDER_ERROR;
-            snprintf(status->message, sizeof(status->message), "Render error: NULL pixel buffer");
-            status->active = true;
-            status->display_time = 5.0f;
-        }
-        return false;
+#define RENDER_TILE 64
+#define MAX_RENDER_THREADS 16
+
+// fills the pixels of [x0, x1) x [y0, y1) and returns how many samples failed to evaluate
+typedef int (*TileKernel)(const void* job, Color* pixels, int x0, int y0, int x1, int y1);
+
+typedef struct {
+    TileKernel kernel;
+    const void* job;
+    Color* pixels;
+    int width;
+    int height;
+    atomic_int next_tile;
+    atomic_int error_count;
+} TileQueue;
+
+static void* tile_worker(void* arg) {
+    TileQueue* queue = arg;
+    int columns = (queue->width + RENDER_TILE - 1) / RENDER_TILE;
+    int rows = (queue->height + RENDER_TILE - 1) / RENDER_TILE;
+    for (;;) {
+        int tile = atomic_fetch_add(&queue->next_tile, 1);
+        if (tile >= columns * rows) break;
+        int x0 = (tile % columns) * RENDER_TILE;
+        int y0 = (tile / columns) * RENDER_TILE;
+        int x1 = x0 + RENDER_TILE < queue->width ? x0 + RENDER_TILE : queue->width;
+        int y1 = y0 + RENDER_TILE < queue->height ? y0 + RENDER_TILE : queue->height;
+        atomic_fetch_add(&queue->error_count, queue->kernel(queue->job, queue->pixels, x0, y0, x1, y1));
     }
+    return NULL;
+}
 
-    float saturation = params.saturation > 0 ? params.saturation : 0.85f;
-    float baseValue = params.value > 0 ? params.value : 0.95f;
-    float contrastStrength = params.contrast_strength > 0 ? params.contrast_strength : 1.0f;
-    int aa_level = params.anti_aliasing > 0 ? params.anti_aliasing : 1;
+// tiles are handed out from a shared counter, so slow regions (poles, slow basins) spread
+// themselves over the cores; returns the total failed-sample count
+int render_tiles(TileKernel kernel, const void* job, Color* pixels, int width, int height) {
+    TileQueue queue = { .kernel = kernel, .job = job, .pixels = pixels, .width = width, .height = height };
+    atomic_init(&queue.next_tile, 0);
+    atomic_init(&queue.error_count, 0);
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int thread_count = cores < 1 ? 1 : (cores > MAX_RENDER_THREADS ? MAX_RENDER_THREADS : (int)cores);
+    pthread_t threads[MAX_RENDER_THREADS];
+    int started = 0;
+    for (int i = 1; i < thread_count; i++) {
+        if (pthread_create(&threads[started], NULL, tile_worker, &queue) == 0) started++;
+    }
+    tile_worker(&queue);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return atomic_load(&queue.error_count);
+}
 
-    double pixel_width = 1.0 / scale;
+typedef struct {
+    FunctionType func_type;
+    double centerX;
+    double centerY;
+    double scale;
+    int width;
+    int height;
+    ColoringParams params;
+    float saturation;
+    float baseValue;
+    float contrastStrength;
+    int aa_level;
+    float* phases;          // arg f at each pixel corner for the zero locator, or NULL
+} DomainColoringJob;
 
+static int domain_coloring_tile(const void* data, Color* pixels, int x0, int y0, int x1, int y1) {
+    const DomainColoringJob* job = data;
+    int aa_level = job->aa_level;
     int error_count = 0;
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
             float r = 0, g = 0, b = 0;
             int valid_samples = 0;
             // supersampling aa
@@ -195,24 +253,27 @@ bool render_domain_coloring(Color *pixels, FunctionType func_type, double center
                 for (int sx = 0; sx < aa_level; sx++) {
                     double sub_x = (double)sx / aa_level;
                     double sub_y = (double)sy / aa_level;
-                    double re = ((x + sub_x) - SCREEN_WIDTH/2) / scale + centerX;
-                    double im = ((SCREEN_HEIGHT/2 - y) - sub_y) / scale + centerY;
+                    double re = ((x + sub_x) - job->width/2) / job->scale + job->centerX;
+                    double im = ((job->height/2 - y) - sub_y) / job->scale + job->centerY;
                     double complex z = re + im * I;
                     bool eval_error = false;
-                    double complex result = evaluate_function(z, func_type, &eval_error);
+                    double complex result = evaluate_function(z, job->func_type, &eval_error);
+                    if (job->phases && sx == 0 && sy == 0) {
+                        job->phases[y * job->width + x] = (eval_error || result == 0.0) ? NAN : (float)carg(result);
+                    }
                     if (eval_error) {
                         error_count++;
                         continue;
                     }
                     double magnitude = cabs(result);
                     double phase = carg(result);
-                    Color color = phase_to_color_hsv(phase, saturation, baseValue);
-                    color = apply_brightness(color, magnitude, params.enhanced_contrast, contrastStrength);
-                    if (params.show_phase_lines) {
-                        color = add_phase_lines(color, phase, params.line_thickness);
+                    Color color = phase_to_color_hsv(phase, job->saturation, job->baseValue);
+                    color = apply_brightness(color, magnitude, job->params.enhanced_contrast, job->contrastStrength);
+                    if (job->params.show_phase_lines) {
+                        color = add_phase_lines(color, phase, job->params.line_thickness);
                     }
-                    if (params.show_modulus_lines) {
-                        color = add_modulus_lines(color, magnitude, params.line_thickness);
+                    if (job->params.show_modulus_lines) {
+                        color = add_modulus_lines(color, magnitude, job->params.line_thickness);
                     }
                     r += color.r;
                     g += color.g;
@@ -227,12 +288,76 @@ bool render_domain_coloring(Color *pixels, FunctionType func_type, double center
                     (unsigned char)(b / valid_samples),
                     255
                 };
-                pixels[y * SCREEN_WIDTH + x] = final_color;
+                pixels[y * job->width + x] = final_color;
             } else {
-                pixels[y * SCREEN_WIDTH + x] = (Color){ 255, 0, 255, 255 };
+                pixels[y * job->width + x] = (Color){ 255, 0, 255, 255 };
+            }
+        }
+    }
+    return error_count;
+}
+
+// evaluate_function over an array, with the switch hoisted out of the loop; points that fail
+// come out as nan and are counted
+int evaluate_function_batch(const double complex* z, double complex* w, int count, FunctionType type) {
+    int errors = 0;
+    switch (type) {
+        case FUNC_SQUARE:
+            for (int i = 0; i < count; i++) w[i] = z[i] * z[i];
+            break;
+        case FUNC_SQUARE_MINUS_ONE:
+            for (int i = 0; i < count; i++) w[i] = z[i] * z[i] - 1.0;
+            break;
+        case FUNC_POLY5_MINUS_Z:
+            for (int i = 0; i < count; i++) {
+                double complex z2 = z[i] * z[i];
+                w[i] = z2 * z2 * z[i] - z[i];
+            }
+            break;
+        default:
+            for (int i = 0; i < count; i++) {
+                bool error = false;
+                w[i] = evaluate_function(z[i], type, &error);
+                if (error) w[i] = NAN;
             }
+            break;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!isfinite(creal(w[i])) || !isfinite(cimag(w[i]))) {
+            w[i] = NAN;
+            errors++;
         }
     }
+    return errors;
+}
+
+bool render_domain_coloring(Color *pixels, FunctionType func_type, double centerX, double centerY, 
+                           double scale, ColoringParams params, StatusMessage *status, float *phases) {
+    if (pixels == NULL) {
+        if (status) {
+            status->status = STATUS_RENDER_ERROR;
+            snprintf(status->message, sizeof(status->message), "Render error: NULL pixel buffer");
+            status->active = true;
+            status->display_time = 5.0f;
+        }
+        return false;
+    }
+
+    DomainColoringJob job = {
+        .func_type = func_type,
+        .centerX = centerX,
+        .centerY = centerY,
+        .scale = scale,
+        .width = SCREEN_WIDTH,
+        .height = SCREEN_HEIGHT,
+        .params = params,
+        .saturation = params.saturation > 0 ? params.saturation : 0.85f,
+        .baseValue = params.value > 0 ? params.value : 0.95f,
+        .contrastStrength = params.contrast_strength > 0 ? params.contrast_strength : 1.0f,
+        .aa_level = params.anti_aliasing > 0 ? params.anti_aliasing : 1,
+        .phases = phases
+    };
+    int error_count = render_tiles(domain_coloring_tile, &job, pixels, SCREEN_WIDTH, SCREEN_HEIGHT);
     if (error_count > 1000 && status) {
         status->status = STATUS_MATH_ERROR;
         snprintf(status->message, sizeof(status->message), 
@@ -244,6 +369,1554 @@ bool render_domain_coloring(Color *pixels, FunctionType func_type, double center
     return true;
 }
 
+#define NEWTON_MAX_DEGREE 12
+#define NEWTON_MAX_ITERATIONS 64
+#define NEWTON_LANES 8
+#define NEWTON_TOLERANCE 1e-9
+
+typedef enum {
+    NEWTON_SQUARE,
+    NEWTON_SQUARE_MINUS_ONE,
+    NEWTON_POLY5_MINUS_Z,
+    NEWTON_CUBE_MINUS_ONE,
+    NEWTON_QUARTIC_MINUS_ONE,
+    NEWTON_OCTIC,
+    NEWTON_CUSTOM,
+    NEWTON_COUNT
+} NewtonPreset;
+
+const char* newton_names[] = {
+    "z^2",
+    "z^2 - 1",
+    "z^5 - z",
+    "z^3 - 1",
+    "z^4 - 1",
+    "z^8 + 15z^4 - 16",
+    "custom"
+};
+
+typedef struct {
+    int degree;
+    double complex coeffs[NEWTON_MAX_DEGREE + 1];  // coeffs[k] multiplies z^k
+    int root_count;                                // distinct roots, repeated ones merged
+    double complex roots[NEWTON_MAX_DEGREE];
+} Polynomial;
+
+// durand-kerner: every root estimate is pulled by all the others at once
+static void polynomial_find_roots(Polynomial* poly) {
+    int n = poly->degree;
+    double complex estimates[NEWTON_MAX_DEGREE];
+    double complex lead = poly->coeffs[n];
+    for (int k = 0; k < n; k++) {
+        estimates[k] = cpow(0.4 + 0.9 * I, k);
+    }
+    for (int iteration = 0; iteration < 500; iteration++) {
+        double largest_change = 0.0;
+        for (int k = 0; k < n; k++) {
+            double complex value = poly->coeffs[n];
+            for (int j = n - 1; j >= 0; j--) {
+                value = value * estimates[k] + poly->coeffs[j];
+            }
+            double complex denominator = lead;
+            for (int j = 0; j < n; j++) {
+                if (j != k) denominator *= estimates[k] - estimates[j];
+            }
+            if (denominator == 0.0) continue;
+            double complex change = value / denominator;
+            estimates[k] -= change;
+            if (cabs(change) > largest_change) largest_change = cabs(change);
+        }
+        if (largest_change < 1e-14) break;
+    }
+    poly->root_count = 0;
+    for (int k = 0; k < n; k++) {
+        bool repeated = false;
+        for (int j = 0; j < poly->root_count; j++) {
+            if (cabs(estimates[k] - poly->roots[j]) < 1e-5) repeated = true;
+        }
+        if (!repeated) poly->roots[poly->root_count++] = estimates[k];
+    }
+}
+
+// the custom polynomial is the product of (z - r) over the roots placed with the mouse
+Polynomial newton_polynomial(NewtonPreset preset, const double complex* custom_roots, int custom_count) {
+    Polynomial poly = { 0 };
+    switch (preset) {
+        case NEWTON_SQUARE:
+            poly.degree = 2;
+            poly.coeffs[2] = 1.0;
+            break;
+        case NEWTON_SQUARE_MINUS_ONE:
+            poly.degree = 2;
+            poly.coeffs[2] = 1.0;
+            poly.coeffs[0] = -1.0;
+            break;
+        case NEWTON_POLY5_MINUS_Z:
+            poly.degree = 5;
+            poly.coeffs[5] = 1.0;
+            poly.coeffs[1] = -1.0;
+            break;
+        case NEWTON_CUBE_MINUS_ONE:
+            poly.degree = 3;
+            poly.coeffs[3] = 1.0;
+            poly.coeffs[0] = -1.0;
+            break;
+        case NEWTON_QUARTIC_MINUS_ONE:
+            poly.degree = 4;
+            poly.coeffs[4] = 1.0;
+            poly.coeffs[0] = -1.0;
+            break;
+        case NEWTON_OCTIC:
+            poly.degree = 8;
+            poly.coeffs[8] = 1.0;
+            poly.coeffs[4] = 15.0;
+            poly.coeffs[0] = -16.0;
+            break;
+        case NEWTON_CUSTOM:
+        default:
+            poly.coeffs[0] = 1.0;
+            for (int k = 0; k < custom_count; k++) {
+                poly.degree++;
+                for (int j = poly.degree; j >= 0; j--) {
+                    poly.coeffs[j] = (j > 0 ? poly.coeffs[j - 1] : 0.0) - custom_roots[k] * poly.coeffs[j];
+                }
+            }
+            break;
+    }
+    polynomial_find_roots(&poly);
+    return poly;
+}
+
+// runs newton's method on a lane of starting points together, in split real arrays so the
+// compiler can vectorize across lanes; a mask retires each lane once it converges, falls
+// into a cycle (brent's power-of-two checkpoints) or lands on a critical point; root is the
+// index of the root reached or -1, iterations a smooth count for shading
+static void newton_lanes(const Polynomial* poly, const double* start_re, const double* start_im, int lanes,
+                         int* root, float* iterations) {
+    double cr[NEWTON_MAX_DEGREE + 1], ci[NEWTON_MAX_DEGREE + 1];
+    for (int k = 0; k <= poly->degree; k++) {
+        cr[k] = creal(poly->coeffs[k]);
+        ci[k] = cimag(poly->coeffs[k]);
+    }
+    double zr[NEWTON_LANES], zi[NEWTON_LANES], saved_r[NEWTON_LANES], saved_i[NEWTON_LANES], last_step[NEWTON_LANES];
+    bool active[NEWTON_LANES];
+    int remaining = 0;
+    for (int l = 0; l < NEWTON_LANES; l++) {
+        active[l] = l < lanes;
+        remaining += active[l];
+        zr[l] = saved_r[l] = l < lanes ? start_re[l] : 0.0;
+        zi[l] = saved_i[l] = l < lanes ? start_im[l] : 0.0;
+        last_step[l] = 1.0;
+        root[l] = -1;
+        iterations[l] = NEWTON_MAX_ITERATIONS;
+    }
+    const double tolerance2 = NEWTON_TOLERANCE * NEWTON_TOLERANCE;
+    for (int n = 1; n <= NEWTON_MAX_ITERATIONS && remaining > 0; n++) {
+        // horner for p and p' over every lane, retired ones included, so this part has no
+        // branches; the mask only gates the bookkeeping below
+        double pr[NEWTON_LANES], pi[NEWTON_LANES], dr[NEWTON_LANES], di[NEWTON_LANES];
+        for (int l = 0; l < NEWTON_LANES; l++) {
+            pr[l] = cr[poly->degree];
+            pi[l] = ci[poly->degree];
+            dr[l] = 0.0;
+            di[l] = 0.0;
+        }
+        for (int k = poly->degree - 1; k >= 0; k--) {
+            for (int l = 0; l < NEWTON_LANES; l++) {
+                double t = dr[l] * zr[l] - di[l] * zi[l] + pr[l];
+                di[l] = dr[l] * zi[l] + di[l] * zr[l] + pi[l];
+                dr[l] = t;
+                t = pr[l] * zr[l] - pi[l] * zi[l] + cr[k];
+                pi[l] = pr[l] * zi[l] + pi[l] * zr[l] + ci[k];
+                pr[l] = t;
+            }
+        }
+        for (int l = 0; l < NEWTON_LANES; l++) {
+            if (!active[l]) continue;
+            double d2 = dr[l] * dr[l] + di[l] * di[l];
+            if (d2 < 1e-300) {
+                active[l] = false;
+                remaining--;
+                continue;
+            }
+            double sr = (pr[l] * dr[l] + pi[l] * di[l]) / d2;
+            double si = (pi[l] * dr[l] - pr[l] * di[l]) / d2;
+            zr[l] -= sr;
+            zi[l] -= si;
+            double step2 = sr * sr + si * si;
+            if (step2 < tolerance2) {
+                // the fraction of the last step still needed to reach the tolerance
+                double fraction = n > 1 ? log(tolerance2 / last_step[l]) / log(step2 / last_step[l]) : 1.0;
+                iterations[l] = (float)(n - 1 + Clamp((float)fraction, 0.0f, 1.0f));
+                double nearest = 1e-6;
+                for (int k = 0; k < poly->root_count; k++) {
+                    double er = zr[l] - creal(poly->roots[k]), ei = zi[l] - cimag(poly->roots[k]);
+                    if (er * er + ei * ei < nearest) {
+                        nearest = er * er + ei * ei;
+                        root[l] = k;
+                    }
+                }
+                active[l] = false;
+                remaining--;
+                continue;
+            }
+            // back at the checkpoint while still taking full-size steps: an attracting cycle
+            double cycle_r = zr[l] - saved_r[l], cycle_i = zi[l] - saved_i[l];
+            if (cycle_r * cycle_r + cycle_i * cycle_i < 1e-8 * step2) {
+                active[l] = false;
+                remaining--;
+                continue;
+            }
+            if ((n & (n - 1)) == 0) {
+                saved_r[l] = zr[l];
+                saved_i[l] = zi[l];
+            }
+            last_step[l] = step2;
+        }
+    }
+}
+
+typedef struct {
+    const Polynomial* poly;
+    double centerX;
+    double centerY;
+    double scale;
+    int width;
+    int height;
+    int aa_level;
+    Color root_colors[NEWTON_MAX_DEGREE];
+} NewtonJob;
+
+// hue picks the root, brightness falls off with the iterations it took
+static Color newton_color(const NewtonJob* job, int root, float iterations) {
+    if (root < 0) return BLACK;
+    Color color = job->root_colors[root];
+    float shade = Clamp(expf(-0.083f * iterations), 0.12f, 1.0f);
+    color.r = (unsigned char)(color.r * shade);
+    color.g = (unsigned char)(color.g * shade);
+    color.b = (unsigned char)(color.b * shade);
+    return color;
+}
+
+static int newton_tile(const void* data, Color* pixels, int x0, int y0, int x1, int y1) {
+    const NewtonJob* job = data;
+    int aa_level = job->aa_level;
+    double start_re[NEWTON_LANES], start_im[NEWTON_LANES];
+    int root[NEWTON_LANES];
+    float iterations[NEWTON_LANES];
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x += NEWTON_LANES) {
+            int lanes = x1 - x < NEWTON_LANES ? x1 - x : NEWTON_LANES;
+            float r[NEWTON_LANES] = { 0 }, g[NEWTON_LANES] = { 0 }, b[NEWTON_LANES] = { 0 };
+            for (int sy = 0; sy < aa_level; sy++) {
+                for (int sx = 0; sx < aa_level; sx++) {
+                    for (int l = 0; l < lanes; l++) {
+                        start_re[l] = ((x + l + (double)sx / aa_level) - job->width/2) / job->scale + job->centerX;
+                        start_im[l] = ((job->height/2 - y) - (double)sy / aa_level) / job->scale + job->centerY;
+                    }
+                    newton_lanes(job->poly, start_re, start_im, lanes, root, iterations);
+                    for (int l = 0; l < lanes; l++) {
+                        Color color = newton_color(job, root[l], iterations[l]);
+                        r[l] += color.r;
+                        g[l] += color.g;
+                        b[l] += color.b;
+                    }
+                }
+            }
+            int samples = aa_level * aa_level;
+            for (int l = 0; l < lanes; l++) {
+                pixels[y * job->width + x + l] = (Color){
+                    (unsigned char)(r[l] / samples),
+                    (unsigned char)(g[l] / samples),
+                    (unsigned char)(b[l] / samples),
+                    255
+                };
+            }
+        }
+    }
+    return 0;
+}
+
+void render_newton_basins(Color *pixels, const Polynomial* poly, double centerX, double centerY, double scale,
+                          ColoringParams params, int width, int height) {
+    NewtonJob job = {
+        .poly = poly,
+        .centerX = centerX,
+        .centerY = centerY,
+        .scale = scale,
+        .width = width,
+        .height = height,
+        .aa_level = params.anti_aliasing > 0 ? params.anti_aliasing : 1
+    };
+    float saturation = params.saturation > 0 ? params.saturation : 0.85f;
+    float value = params.value > 0 ? params.value : 0.95f;
+    for (int k = 0; k < poly->root_count; k++) {
+        job.root_colors[k] = ColorFromHSV(360.0f * k / poly->root_count + 20.0f, saturation, value);
+    }
+    render_tiles(newton_tile, &job, pixels, width, height);
+}
+
+// deep zoom: one reference orbit in fixed point, every pixel as a double-precision
+// perturbation of it; deltas past the double exponent range are carried scaled by 2^exponent
+#define BIG_LIMBS 64
+#define DEEP_MIN_EXPONENT -1900
+#define DEEP_BAILOUT 256.0
+#define DEEP_REUSE_PIXELS (2 * SCREEN_WIDTH)
+#define DEEP_COARSE_BLOCK 8
+
+// two's complement fixed point, most significant limb first: limb[0] is the integer part
+// and limb[i] weighs 2^(-32 i); operations only touch the first `limbs` limbs
+typedef struct {
+    uint32_t limb[BIG_LIMBS];
+} BigFixed;
+
+static bool big_is_negative(const BigFixed* a) {
+    return a->limb[0] >> 31;
+}
+
+static void big_negate(BigFixed* a, int limbs) {
+    uint64_t carry = 1;
+    for (int i = limbs - 1; i >= 0; i--) {
+        uint64_t t = (uint64_t)(uint32_t)~a->limb[i] + carry;
+        a->limb[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+}
+
+static BigFixed big_add(const BigFixed* a, const BigFixed* b, int limbs) {
+    BigFixed r = { { 0 } };
+    uint64_t carry = 0;
+    for (int i = limbs - 1; i >= 0; i--) {
+        uint64_t t = (uint64_t)a->limb[i] + b->limb[i] + carry;
+        r.limb[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    return r;
+}
+
+static BigFixed big_sub(const BigFixed* a, const BigFixed* b, int limbs) {
+    BigFixed negated = *b;
+    big_negate(&negated, limbs);
+    return big_add(a, &negated, limbs);
+}
+
+// schoolbook product of the magnitudes, truncated back to the same fixed point
+static BigFixed big_mul(const BigFixed* a, const BigFixed* b, int limbs) {
+    BigFixed x = *a, y = *b;
+    bool negative = big_is_negative(&x) != big_is_negative(&y);
+    if (big_is_negative(&x)) big_negate(&x, limbs);
+    if (big_is_negative(&y)) big_negate(&y, limbs);
+    uint32_t product[2 * BIG_LIMBS] = { 0 };
+    for (int i = limbs - 1; i >= 0; i--) {
+        uint64_t carry = 0;
+        for (int j = limbs - 1; j >= 0; j--) {
+            uint64_t t = (uint64_t)x.limb[i] * y.limb[j] + product[i + j + 1] + carry;
+            product[i + j + 1] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        product[i] = (uint32_t)carry;
+    }
+    BigFixed r = { { 0 } };
+    for (int i = 0; i < limbs; i++) {
+        r.limb[i] = product[i + 1];
+    }
+    if (negative) big_negate(&r, limbs);
+    return r;
+}
+
+// adds value * 2^exponent exactly, bit by bit from the 53-bit mantissa
+static void big_add_scaled(BigFixed* a, double value, int exponent, int limbs) {
+    if (value == 0.0) return;
+    int k;
+    double mantissa = frexp(fabs(value), &k);
+    uint64_t bits = (uint64_t)ldexp(mantissa, 53);
+    BigFixed term = { { 0 } };
+    for (int b = 0; b < 53; b++) {
+        if (!((bits >> b) & 1)) continue;
+        int weight = k - 53 + exponent + b;  // this bit is worth 2^weight
+        if (weight >= 0) {
+            if (weight < 31) term.limb[0] |= 1u << weight;
+            continue;
+        }
+        int fraction = -weight - 1;
+        int index = fraction / 32 + 1;
+        if (index < limbs) term.limb[index] |= 1u << (31 - fraction % 32);
+    }
+    if (value < 0.0) big_negate(&term, limbs);
+    *a = big_add(a, &term, limbs);
+}
+
+static BigFixed big_from_double(double value, int limbs) {
+    BigFixed r = { { 0 } };
+    big_add_scaled(&r, value, 0, limbs);
+    return r;
+}
+
+// the value divided by 2^exponent, from its three leading nonzero limbs
+static double big_to_double(const BigFixed* a, int exponent, int limbs) {
+    BigFixed x = *a;
+    bool negative = big_is_negative(&x);
+    if (negative) big_negate(&x, limbs);
+    int first = 0;
+    while (first < limbs && x.limb[first] == 0) first++;
+    if (first == limbs) return 0.0;
+    double value = 0.0;
+    for (int i = first; i < first + 3 && i < limbs; i++) {
+        value += ldexp((double)x.limb[i], -32 * i - exponent);
+    }
+    return negative ? -value : value;
+}
+
+// a complex double with its own binary exponent, for series coefficients that outgrow doubles
+typedef struct {
+    double complex m;
+    int e;
+} ScaledComplex;
+
+static ScaledComplex scaled_normalize(double complex m, int e) {
+    double largest = fmax(fabs(creal(m)), fabs(cimag(m)));
+    if (largest == 0.0) return (ScaledComplex){ 0.0, 0 };
+    int k;
+    frexp(largest, &k);
+    return (ScaledComplex){ ldexp(creal(m), -k) + ldexp(cimag(m), -k) * I, e + k };
+}
+
+static ScaledComplex scaled_mul(ScaledComplex a, ScaledComplex b) {
+    return scaled_normalize(a.m * b.m, a.e + b.e);
+}
+
+static ScaledComplex scaled_add(ScaledComplex a, ScaledComplex b) {
+    if (a.m == 0.0) return b;
+    if (b.m == 0.0) return a;
+    if (a.e < b.e) {
+        ScaledComplex t = a;
+        a = b;
+        b = t;
+    }
+    if (a.e - b.e > 64) return a;
+    int shift = b.e - a.e;
+    return scaled_normalize(a.m + ldexp(creal(b.m), shift) + ldexp(cimag(b.m), shift) * I, a.e);
+}
+
+static double scaled_log2(ScaledComplex a) {
+    return a.m == 0.0 ? -INFINITY : log2(cabs(a.m)) + a.e;
+}
+
+static double complex scaled_to_double(ScaledComplex a, int shift) {
+    return ldexp(creal(a.m), a.e + shift) + ldexp(cimag(a.m), a.e + shift) * I;
+}
+
+// the view: its centre in fixed point, pixel size pixel * 2^exponent with pixel in [0.5, 1);
+// julia views perturb the starting point under a fixed c instead of c itself
+typedef struct {
+    BigFixed center_re;
+    BigFixed center_im;
+    double pixel;
+    int exponent;
+    int max_iterations;
+    bool julia;
+    double complex julia_c;
+} DeepView;
+
+typedef struct {
+    double* orbit_re;       // Z_0 .. Z_length as doubles
+    double* orbit_im;
+    int capacity;
+    int length;             // where the reference escaped, or max_iterations
+    int max_iterations;
+    BigFixed point_re;      // c for mandelbrot, Z_0 for julia
+    BigFixed point_im;
+    int limbs;
+    bool julia;
+    double complex julia_c;
+    bool valid;
+    double milliseconds;
+} DeepReference;
+
+typedef struct {
+    ScaledComplex a, b, c;  // delta_n ~ a dc + b dc^2 + c dc^3
+    int skip;
+} DeepSeries;
+
+static int deep_limbs(int exponent) {
+    int limbs = -exponent / 32 + 4;
+    return limbs < 4 ? 4 : (limbs > BIG_LIMBS ? BIG_LIMBS : limbs);
+}
+
+DeepView deep_view_default(bool julia) {
+    DeepView view = { .max_iterations = 1000, .julia = julia, .julia_c = -0.8 + 0.156 * I };
+    view.center_re = big_from_double(julia ? 0.0 : -0.75, BIG_LIMBS);
+    view.center_im = big_from_double(0.0, BIG_LIMBS);
+    view.pixel = frexp(3.0 / SCREEN_WIDTH, &view.exponent);
+    return view;
+}
+
+void deep_view_zoom(DeepView* view, double factor) {
+    int k;
+    double pixel = frexp(view->pixel / factor, &k);
+    if (view->exponent + k < DEEP_MIN_EXPONENT) return;
+    if (ldexp(pixel, view->exponent + k) > 0.02) return;
+    view->pixel = pixel;
+    view->exponent += k;
+}
+
+void deep_view_pan(DeepView* view, double dx_pixels, double dy_pixels) {
+    big_add_scaled(&view->center_re, dx_pixels * view->pixel, view->exponent, BIG_LIMBS);
+    big_add_scaled(&view->center_im, dy_pixels * view->pixel, view->exponent, BIG_LIMBS);
+}
+
+// log10 of the magnification against the starting view
+double deep_view_depth(const DeepView* view) {
+    return log10(3.0 / SCREEN_WIDTH) - log10(view->pixel) - view->exponent * log10(2.0);
+}
+
+typedef struct {
+    DeepReference reference;
+    DeepView view;
+    pthread_t thread;
+    bool running;           // started and not joined yet
+    atomic_bool done;
+    atomic_bool cancel;
+    atomic_int progress;    // iterations so far
+} DeepReferenceTask;
+
+// a reference covers a view while it has the precision for the zoom, runs far enough, and
+// sits within a couple of screens of the view; rebasing takes care of the rest. one still
+// being computed has no length yet, so only its iteration limit counts
+static bool deep_reference_covers(const DeepReference* reference, const DeepView* view, bool finished) {
+    if (reference->julia != view->julia || reference->julia_c != view->julia_c) return false;
+    if (reference->limbs < deep_limbs(view->exponent)) return false;
+    if ((!finished || reference->length == reference->max_iterations) &&
+        reference->max_iterations < view->max_iterations) return false;
+    BigFixed dx = big_sub(&view->center_re, &reference->point_re, reference->limbs);
+    BigFixed dy = big_sub(&view->center_im, &reference->point_im, reference->limbs);
+    double ox = big_to_double(&dx, view->exponent, reference->limbs) / view->pixel;
+    double oy = big_to_double(&dy, view->exponent, reference->limbs) / view->pixel;
+    return ox * ox + oy * oy < (double)DEEP_REUSE_PIXELS * DEEP_REUSE_PIXELS;
+}
+
+static bool deep_reference_usable(const DeepReference* reference, const DeepView* view) {
+    return reference->valid && deep_reference_covers(reference, view, true);
+}
+
+// iterates the view centre at full precision, keeping each Z_n as doubles; runs on its own
+// thread and gives up as soon as cancel is set
+static void* deep_reference_worker(void* data) {
+    DeepReferenceTask* task = data;
+    DeepReference* reference = &task->reference;
+    const DeepView* view = &task->view;
+    double start = GetTime();
+    int limbs = reference->limbs;
+    BigFixed x, y, cx, cy;
+    if (view->julia) {
+        x = view->center_re;
+        y = view->center_im;
+        cx = big_from_double(creal(view->julia_c), limbs);
+        cy = big_from_double(cimag(view->julia_c), limbs);
+    } else {
+        x = big_from_double(0.0, limbs);
+        y = big_from_double(0.0, limbs);
+        cx = view->center_re;
+        cy = view->center_im;
+    }
+    reference->orbit_re[0] = big_to_double(&x, 0, limbs);
+    reference->orbit_im[0] = big_to_double(&y, 0, limbs);
+    for (int n = 0; n < view->max_iterations; n++) {
+        if (atomic_load_explicit(&task->cancel, memory_order_relaxed)) return NULL;
+        if ((n & 1023) == 0) atomic_store_explicit(&task->progress, n, memory_order_relaxed);
+        BigFixed x2 = big_mul(&x, &x, limbs);
+        BigFixed y2 = big_mul(&y, &y, limbs);
+        BigFixed xy = big_mul(&x, &y, limbs);
+        BigFixed re = big_sub(&x2, &y2, limbs);
+        x = big_add(&re, &cx, limbs);
+        BigFixed xy2 = big_add(&xy, &xy, limbs);
+        y = big_add(&xy2, &cy, limbs);
+        double zr = big_to_double(&x, 0, limbs), zi = big_to_double(&y, 0, limbs);
+        reference->orbit_re[n + 1] = zr;
+        reference->orbit_im[n + 1] = zi;
+        if (zr * zr + zi * zi > 4.0) {
+            reference->length = n + 1;
+            break;
+        }
+    }
+    reference->valid = true;
+    reference->milliseconds = (GetTime() - start) * 1000.0;
+    atomic_store(&task->done, true);
+    return NULL;
+}
+
+static bool deep_reference_pending(DeepReferenceTask* task) {
+    return task->running || atomic_load(&task->done);
+}
+
+static void deep_reference_stop(DeepReferenceTask* task) {
+    if (task->running) {
+        atomic_store(&task->cancel, true);
+        pthread_join(task->thread, NULL);
+        task->running = false;
+    }
+    atomic_store(&task->done, false);
+}
+
+// drops any orbit in flight and starts one at the view centre; the header and buffers are
+// set up here, so the main thread can check what the task covers while it runs. false when
+// the orbit does not fit in memory
+static bool deep_reference_start(DeepReferenceTask* task, const DeepView* view) {
+    deep_reference_stop(task);
+    DeepReference* reference = &task->reference;
+    reference->valid = false;
+    if (reference->capacity < view->max_iterations + 1) {
+        free(reference->orbit_re);
+        free(reference->orbit_im);
+        reference->capacity = view->max_iterations + 1;
+        reference->orbit_re = malloc(sizeof(double) * reference->capacity);
+        reference->orbit_im = malloc(sizeof(double) * reference->capacity);
+        if (reference->orbit_re == NULL || reference->orbit_im == NULL) {
+            free(reference->orbit_re);
+            free(reference->orbit_im);
+            reference->orbit_re = NULL;
+            reference->orbit_im = NULL;
+            reference->capacity = 0;
+            return false;
+        }
+    }
+    reference->point_re = view->center_re;
+    reference->point_im = view->center_im;
+    reference->limbs = deep_limbs(view->exponent);
+    reference->julia = view->julia;
+    reference->julia_c = view->julia_c;
+    reference->max_iterations = view->max_iterations;
+    reference->length = view->max_iterations;
+    task->view = *view;
+    atomic_store(&task->cancel, false);
+    atomic_store(&task->progress, 0);
+    // without a thread the orbit is computed right here
+    task->running = pthread_create(&task->thread, NULL, deep_reference_worker, task) == 0;
+    if (!task->running) deep_reference_worker(task);
+    return true;
+}
+
+// swaps a finished orbit in, handing the old buffers to the task for the next one
+static bool deep_reference_collect(DeepReferenceTask* task, DeepReference* reference) {
+    if (!atomic_load(&task->done)) return false;
+    deep_reference_stop(task);
+    DeepReference finished = task->reference;
+    task->reference = *reference;
+    *reference = finished;
+    return true;
+}
+
+// runs the cubic series along the reference until its cubic term, at the farthest pixel
+// of radius 2^radius_log2, stops being negligible next to the linear one
+static DeepSeries deep_series(const DeepReference* reference, double radius_log2, bool julia, int max_iterations) {
+    DeepSeries series = { { julia ? 1.0 : 0.0, 0 }, { 0.0, 0 }, { 0.0, 0 }, 0 };
+    ScaledComplex one = { 1.0, 0 };
+    int limit = reference->length - 1 < max_iterations - 1 ? reference->length - 1 : max_iterations - 1;
+    for (int n = 0; n < limit; n++) {
+        ScaledComplex twice_z = scaled_normalize(2.0 * (reference->orbit_re[n] + reference->orbit_im[n] * I), 0);
+        ScaledComplex a = scaled_mul(twice_z, series.a);
+        if (!julia) a = scaled_add(a, one);
+        ScaledComplex b = scaled_add(scaled_mul(twice_z, series.b), scaled_mul(series.a, series.a));
+        ScaledComplex ab = scaled_mul(series.a, series.b);
+        ab.e += 1;
+        ScaledComplex c = scaled_add(scaled_mul(twice_z, series.c), ab);
+        if (a.m != 0.0 && scaled_log2(c) + 2.0 * radius_log2 > scaled_log2(a) - 27.0) break;
+        series.a = a;
+        series.b = b;
+        series.c = c;
+        series.skip = n + 1;
+    }
+    return series;
+}
+
+typedef struct {
+    const DeepReference* reference;
+    DeepSeries series;
+    double offset_re;       // (view centre - reference point) / 2^exponent
+    double offset_im;
+    double pixel;
+    int exponent;
+    int width;
+    int height;
+    int max_iterations;
+    bool julia;
+    double cycle;           // squared distance under which a return to a checkpoint counts
+    int block;              // one pixel per block x block cell, as in JuliaJob
+    int previous_block;
+    atomic_bool* cancel;
+} DeepJob;
+
+static Color deep_color(double smooth) {
+    if (smooth < 0.0) return BLACK;
+    float hue = (float)fmod(smooth * 6.0, 360.0);
+    float value = Clamp((float)(0.35 + 0.65 * sin(smooth * 0.15) * sin(smooth * 0.15)), 0.0f, 1.0f);
+    return ColorFromHSV(hue, 0.7f, 0.3f + 0.7f * value);
+}
+
+// smooth escape count of one pixel, or -1 inside; u is its offset from the reference in
+// units of 2^exponent. while the delta is too small for a double it lives in those units
+// (d = delta / 2^exponent), and rebasing onto the start of the orbit whenever the pixel
+// comes closer to it than to the reference keeps the perturbation free of glitches
+static double deep_pixel(const DeepJob* job, double ur, double ui) {
+    const DeepReference* reference = job->reference;
+    const double* zr = reference->orbit_re;
+    const double* zi = reference->orbit_im;
+    double scale = ldexp(1.0, job->exponent);
+    double threshold = ldexp(1.0, -960 - job->exponent);
+    double complex u = ur + ui * I;
+    ScaledComplex su = scaled_normalize(u, 0);
+    ScaledComplex su2 = scaled_mul(su, su);
+    ScaledComplex b = scaled_mul(job->series.b, su2);
+    ScaledComplex c = scaled_mul(job->series.c, scaled_mul(su2, su));
+    b.e += job->exponent;
+    c.e += 2 * job->exponent;
+    ScaledComplex d0 = scaled_add(scaled_add(scaled_mul(job->series.a, su), b), c);
+    int n = job->series.skip, m = job->series.skip;
+    double dcr = job->julia ? 0.0 : ur, dci = job->julia ? 0.0 : ui;
+    double dr, di;
+    bool scaled = job->exponent < -960 && (d0.m == 0.0 || d0.e < -960 - job->exponent);
+    if (scaled) {
+        double complex d = scaled_to_double(d0, 0);
+        dr = creal(d);
+        di = cimag(d);
+    } else {
+        double complex d = scaled_to_double(d0, job->exponent);
+        dr = creal(d);
+        di = cimag(d);
+    }
+    while (scaled && n < job->max_iterations) {
+        if (m == reference->length || fabs(dr) > threshold || fabs(di) > threshold) break;
+        double sr = scale * dr, si = scale * di;
+        double nr = 2.0 * (zr[m] * dr - zi[m] * di) + (sr * dr - si * di) + dcr;
+        double ni = 2.0 * (zr[m] * di + zi[m] * dr) + 2.0 * sr * di + dci;
+        dr = nr;
+        di = ni;
+        m++;
+        n++;
+    }
+    if (scaled) {
+        dr = ldexp(dr, job->exponent);
+        di = ldexp(di, job->exponent);
+    }
+    dcr = job->julia ? 0.0 : ldexp(ur, job->exponent);
+    dci = job->julia ? 0.0 : ldexp(ui, job->exponent);
+    // the checkpoint cycle test of julia_orbit, on the full value of the orbit
+    double saved_r = zr[m] + dr, saved_i = zi[m] + di;
+    int next_checkpoint = n + 1;
+    while (n < job->max_iterations) {
+        if (m == reference->length) {
+            dr += zr[m] - zr[0];
+            di += zi[m] - zi[0];
+            m = 0;
+        }
+        double nr = 2.0 * (zr[m] * dr - zi[m] * di) + dr * dr - di * di + dcr;
+        double ni = 2.0 * (zr[m] * di + zi[m] * dr) + 2.0 * dr * di + dci;
+        dr = nr;
+        di = ni;
+        m++;
+        n++;
+        double xr = zr[m] + dr, xi = zi[m] + di;
+        double r2 = xr * xr + xi * xi;
+        if (r2 > DEEP_BAILOUT) {
+            return n + 1.0 - log2(0.5 * log(r2));
+        }
+        double er = xr - saved_r, ei = xi - saved_i;
+        if (er * er + ei * ei < job->cycle) return -1.0;
+        if (n == next_checkpoint) {
+            saved_r = xr;
+            saved_i = xi;
+            next_checkpoint *= 2;
+        }
+        double rr = xr - zr[0], ri = xi - zi[0];
+        if (rr * rr + ri * ri < dr * dr + di * di) {
+            dr = rr;
+            di = ri;
+            m = 0;
+        }
+    }
+    return -1.0;
+}
+
+// gives up on the rest of the tile once the pass is cancelled
+static int deep_tile(const void* data, Color* pixels, int x0, int y0, int x1, int y1) {
+    const DeepJob* job = data;
+    int b = job->block;
+    for (int y = y0; y < y1; y += b) {
+        if (atomic_load_explicit(job->cancel, memory_order_relaxed)) return 0;
+        for (int x = x0; x < x1; x += b) {
+            Color color;
+            if (job->previous_block && x % job->previous_block == 0 && y % job->previous_block == 0) {
+                color = pixels[y * job->width + x];
+            } else {
+                double ur = job->offset_re + (x - job->width/2) * job->pixel;
+                double ui = job->offset_im + (job->height/2 - y) * job->pixel;
+                color = deep_color(deep_pixel(job, ur, ui));
+            }
+            for (int fy = y; fy < y + b && fy < y1; fy++) {
+                for (int fx = x; fx < x + b && fx < x1; fx++) {
+                    pixels[fy * job->width + fx] = color;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// the pixel passes of a deep view run on their own thread, coarse to fine like the julia
+// view; each finished pass is copied to shown for the main thread to upload, and a new
+// view cancels the passes in flight
+typedef struct {
+    Color* pixels;          // the passes render here, each reusing the coarser one
+    Color* shown;           // the last finished pass
+    bool fresh;             // shown is not uploaded yet; shown and fresh are under lock
+    pthread_mutex_t lock;
+    int width;
+    int height;
+    DeepView view;
+    const DeepReference* reference;
+    pthread_t thread;
+    bool running;           // started and not joined yet
+    atomic_bool done;
+    atomic_bool cancel;
+} DeepRenderTask;
+
+// the series for this view's radius, then the passes across the tile pool; the reference
+// has to be usable for the view and stay put until the task stops
+static void* deep_render_worker(void* data) {
+    DeepRenderTask* task = data;
+    const DeepView* view = &task->view;
+    const DeepReference* reference = task->reference;
+    BigFixed dx = big_sub(&view->center_re, &reference->point_re, reference->limbs);
+    BigFixed dy = big_sub(&view->center_im, &reference->point_im, reference->limbs);
+    DeepJob job = {
+        .reference = reference,
+        .offset_re = big_to_double(&dx, view->exponent, reference->limbs),
+        .offset_im = big_to_double(&dy, view->exponent, reference->limbs),
+        .pixel = view->pixel,
+        .exponent = view->exponent,
+        .width = task->width,
+        .height = task->height,
+        .max_iterations = view->max_iterations,
+        .julia = view->julia,
+        .cancel = &task->cancel
+    };
+    // a thousandth of a pixel, so orbits that only pass near each other stay apart; below
+    // about 1e-13 doubles cannot resolve that and the test just stops firing
+    double tolerance = fmin(1e-10, ldexp(view->pixel, view->exponent) * 1e-3);
+    job.cycle = tolerance * tolerance;
+    double radius = hypot(fabs(job.offset_re) + task->width / 2 * view->pixel,
+                          fabs(job.offset_im) + task->height / 2 * view->pixel);
+    job.series = deep_series(reference, log2(radius) + view->exponent, view->julia, view->max_iterations);
+    for (int block = DEEP_COARSE_BLOCK; block >= 1; block /= 2) {
+        job.block = block;
+        job.previous_block = block == DEEP_COARSE_BLOCK ? 0 : 2 * block;
+        render_tiles(deep_tile, &job, task->pixels, task->width, task->height);
+        if (atomic_load(&task->cancel)) return NULL;
+        pthread_mutex_lock(&task->lock);
+        memcpy(task->shown, task->pixels, sizeof(Color) * task->width * task->height);
+        task->fresh = true;
+        pthread_mutex_unlock(&task->lock);
+    }
+    atomic_store(&task->done, true);
+    return NULL;
+}
+
+static bool deep_render_init(DeepRenderTask* task, int width, int height) {
+    task->width = width;
+    task->height = height;
+    task->pixels = malloc(sizeof(Color) * width * height);
+    task->shown = malloc(sizeof(Color) * width * height);
+    pthread_mutex_init(&task->lock, NULL);
+    return task->pixels != NULL && task->shown != NULL;
+}
+
+// a stopped task drops any pass not uploaded yet, it belongs to a view that is gone
+static void deep_render_stop(DeepRenderTask* task) {
+    if (task->running) {
+        atomic_store(&task->cancel, true);
+        pthread_join(task->thread, NULL);
+        task->running = false;
+    }
+    task->fresh = false;
+}
+
+static void deep_render_free(DeepRenderTask* task) {
+    deep_render_stop(task);
+    pthread_mutex_destroy(&task->lock);
+    free(task->pixels);
+    free(task->shown);
+}
+
+// false when the pixel buffers could not be allocated
+static bool deep_render_start(DeepRenderTask* task, const DeepView* view, const DeepReference* reference) {
+    if (task->pixels == NULL || task->shown == NULL) return false;
+    deep_render_stop(task);
+    task->view = *view;
+    task->reference = reference;
+    atomic_store(&task->cancel, false);
+    atomic_store(&task->done, false);
+    // without a thread the passes run right here
+    task->running = pthread_create(&task->thread, NULL, deep_render_worker, task) == 0;
+    if (!task->running) deep_render_worker(task);
+    return true;
+}
+
+// uploads the newest finished pass, if any, and joins the thread once the last one is in
+static bool deep_render_collect(DeepRenderTask* task, Texture2D texture) {
+    pthread_mutex_lock(&task->lock);
+    bool fresh = task->fresh;
+    if (fresh) UpdateTexture(texture, task->shown);
+    task->fresh = false;
+    pthread_mutex_unlock(&task->lock);
+    if (task->running && atomic_load(&task->done)) {
+        pthread_join(task->thread, NULL);
+        task->running = false;
+    }
+    return fresh;
+}
+
+#define JULIA_BAILOUT 1e6
+#define JULIA_COARSE_BLOCK 8
+#define JULIA_INSET_WIDTH 200
+#define JULIA_INSET_HEIGHT 160
+
+typedef enum {
+    ORBIT_ESCAPED,
+    ORBIT_PERIODIC,
+    ORBIT_UNDECIDED
+} OrbitFate;
+
+// iterates z -> z^2 + c with the derivative carried alongside for the distance estimate,
+// dz/dz0 for a julia set or dz/dc in the parameter plane; an orbit that comes back to its last
+// power-of-two checkpoint has fallen into an attracting cycle and is interior, which ends
+// most interior pixels long before the iteration limit
+static OrbitFate julia_orbit(double zr, double zi, double cr, double ci, bool parameter_plane, int max_iterations,
+                             double* smooth, double* distance, int* period) {
+    double dr = parameter_plane ? 0.0 : 1.0, di = 0.0;
+    double saved_r = zr, saved_i = zi;
+    int checkpoint = 0, next_checkpoint = 1;
+    for (int n = 0; n < max_iterations; n++) {
+        double t = 2.0 * (zr * dr - zi * di) + (parameter_plane ? 1.0 : 0.0);
+        di = 2.0 * (zr * di + zi * dr);
+        dr = t;
+        t = zr * zr - zi * zi + cr;
+        zi = 2.0 * zr * zi + ci;
+        zr = t;
+        double r2 = zr * zr + zi * zi;
+        if (r2 > JULIA_BAILOUT) {
+            *smooth = n + 1.0 - log2(0.5 * log(r2));
+            *distance = 0.5 * sqrt(r2 / (dr * dr + di * di)) * log(r2);
+            return ORBIT_ESCAPED;
+        }
+        double er = zr - saved_r, ei = zi - saved_i;
+        if (er * er + ei * ei < 1e-20) {
+            *period = n + 1 - checkpoint;
+            return ORBIT_PERIODIC;
+        }
+        if (n + 1 == next_checkpoint) {
+            saved_r = zr;
+            saved_i = zi;
+            checkpoint = n + 1;
+            next_checkpoint *= 2;
+        }
+    }
+    return ORBIT_UNDECIDED;
+}
+
+// outside: hue runs with the escape count and the distance estimate darkens the last
+// pixel or so around the boundary; inside: a muted hue per attracting period
+static Color julia_color(OrbitFate fate, double smooth, double distance, int period, double pixel_size,
+                         float saturation, float value) {
+    if (fate == ORBIT_PERIODIC) {
+        return ColorFromHSV((float)((period * 47) % 360), 0.5f * saturation, 0.35f * value);
+    }
+    if (fate == ORBIT_UNDECIDED) return BLACK;
+    float shade = Clamp(powf((float)(distance / pixel_size), 0.3f), 0.0f, 1.0f);
+    return ColorFromHSV((float)fmod(200.0 + smooth * 5.0, 360.0), 0.6f * saturation, value * shade);
+}
+
+typedef struct {
+    double complex c;
+    double centerX;
+    double centerY;
+    double scale;
+    int width;
+    int height;
+    int block;              // renders one pixel per block x block cell and fills the cell
+    int previous_block;     // cells on this coarser grid are already done, or 0
+    int max_iterations;
+    float saturation;
+    float value;
+} JuliaJob;
+
+static int julia_tile(const void* data, Color* pixels, int x0, int y0, int x1, int y1) {
+    const JuliaJob* job = data;
+    int b = job->block;
+    for (int y = y0; y < y1; y += b) {
+        for (int x = x0; x < x1; x += b) {
+            Color color;
+            if (job->previous_block && x % job->previous_block == 0 && y % job->previous_block == 0) {
+                color = pixels[y * job->width + x];
+            } else {
+                double zr = (x - job->width/2) / job->scale + job->centerX;
+                double zi = (job->height/2 - y) / job->scale + job->centerY;
+                double smooth = 0.0, distance = 0.0;
+                int period = 0;
+                OrbitFate fate = julia_orbit(zr, zi, creal(job->c), cimag(job->c), false, job->max_iterations,
+                                             &smooth, &distance, &period);
+                color = julia_color(fate, smooth, distance, period, 1.0 / job->scale, job->saturation, job->value);
+            }
+            for (int fy = y; fy < y + b && fy < y1; fy++) {
+                for (int fx = x; fx < x + b && fx < x1; fx++) {
+                    pixels[fy * job->width + fx] = color;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// one pass of the progressive render: block sizes halve from JULIA_COARSE_BLOCK down to 1
+// over successive frames, and each pass skips the cells the previous one already computed
+void render_julia(Color* pixels, double complex c, double centerX, double centerY, double scale,
+                  ColoringParams params, int block, int previous_block, int width, int height) {
+    JuliaJob job = {
+        .c = c,
+        .centerX = centerX,
+        .centerY = centerY,
+        .scale = scale,
+        .width = width,
+        .height = height,
+        .block = block,
+        .previous_block = previous_block,
+        .max_iterations = 1000,
+        .saturation = params.saturation > 0 ? params.saturation : 0.85f,
+        .value = params.value > 0 ? params.value : 0.95f
+    };
+    render_tiles(julia_tile, &job, pixels, width, height);
+}
+
+// the parameter plane behind the c picker, rendered once
+Color* render_julia_inset(void) {
+    Color* pixels = malloc(sizeof(Color) * JULIA_INSET_WIDTH * JULIA_INSET_HEIGHT);
+    if (pixels == NULL) return NULL;
+    double pixel_size = 3.0 / JULIA_INSET_WIDTH;
+    for (int y = 0; y < JULIA_INSET_HEIGHT; y++) {
+        for (int x = 0; x < JULIA_INSET_WIDTH; x++) {
+            double cr = -0.6 + (x - JULIA_INSET_WIDTH/2) * pixel_size;
+            double ci = (JULIA_INSET_HEIGHT/2 - y) * pixel_size;
+            double smooth = 0.0, distance = 0.0;
+            int period = 0;
+            OrbitFate fate = julia_orbit(0.0, 0.0, cr, ci, true, 200, &smooth, &distance, &period);
+            pixels[y * JULIA_INSET_WIDTH + x] = julia_color(fate, smooth, distance, period, pixel_size, 0.85f, 0.95f);
+        }
+    }
+    return pixels;
+}
+
+double complex julia_inset_point(Rectangle inset, Vector2 mouse) {
+    double pixel_size = 3.0 / JULIA_INSET_WIDTH;
+    return (-0.6 + (mouse.x - inset.x - JULIA_INSET_WIDTH/2) * pixel_size) +
+           ((JULIA_INSET_HEIGHT/2 - (mouse.y - inset.y)) * pixel_size) * I;
+}
+
+#define CONTOUR_MAX_POINTS 2048
+#define CONTOUR_MAX_INTERVALS 8192
+#define CONTOUR_MAX_LEVELS 48
+
+// a contour drawn over the plane: a polyline, closed back to its start or not
+typedef struct {
+    double complex points[CONTOUR_MAX_POINTS];
+    int count;
+    bool closed;
+} Contour;
+
+typedef struct {
+    double complex value;
+    double error;
+    int evaluations;
+    int intervals;
+    bool singular;          // some piece never converged or hit a pole: one lies on the path
+} ContourIntegral;
+
+// 15-point kronrod nodes on [0, 1] of the half-interval; the odd ones carry the 7-point gauss rule
+static const double kronrod_nodes[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.0
+};
+static const double kronrod_weights[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+static const double gauss_weights[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+
+typedef struct {
+    int segment;
+    double t0, t1;
+} ContourInterval;
+
+// adaptive gauss-kronrod along each straight piece z0 + t (z1 - z0), t in [0, 1], refined
+// breadth first: every level gathers the nodes of all its pending intervals into one batch
+// evaluation, keeps the intervals whose |K15 - G7| is small, and halves the rest, so the work
+// piles up only where the integrand is rough, near poles
+ContourIntegral integrate_contour(const Contour* contour, FunctionType type) {
+    ContourIntegral result = { 0 };
+    int segments = contour->closed ? contour->count : contour->count - 1;
+    if (segments < 1) return result;
+    static ContourInterval pending[2][CONTOUR_MAX_INTERVALS];
+    static double complex z[CONTOUR_MAX_INTERVALS * 15], w[CONTOUR_MAX_INTERVALS * 15];
+    int count = 0;
+    for (int s = 0; s < segments && count < CONTOUR_MAX_INTERVALS; s++) {
+        pending[0][count++] = (ContourInterval){ s, 0.0, 1.0 };
+    }
+    for (int level = 0; count > 0; level++) {
+        ContourInterval* current = pending[level % 2];
+        ContourInterval* next = pending[(level + 1) % 2];
+        for (int i = 0; i < count; i++) {
+            double complex a = contour->points[current[i].segment];
+            double complex b = contour->points[(current[i].segment + 1) % contour->count];
+            double center = 0.5 * (current[i].t0 + current[i].t1);
+            double half = 0.5 * (current[i].t1 - current[i].t0);
+            for (int k = 0; k < 7; k++) {
+                z[i * 15 + 2 * k] = a + (center - half * kronrod_nodes[k]) * (b - a);
+                z[i * 15 + 2 * k + 1] = a + (center + half * kronrod_nodes[k]) * (b - a);
+            }
+            z[i * 15 + 14] = a + center * (b - a);
+        }
+        evaluate_function_batch(z, w, count * 15, type);
+        result.evaluations += count * 15;
+        int next_count = 0;
+        for (int i = 0; i < count; i++) {
+            double complex a = contour->points[current[i].segment];
+            double complex b = contour->points[(current[i].segment + 1) % contour->count];
+            double half = 0.5 * (current[i].t1 - current[i].t0);
+            const double complex* f = &w[i * 15];
+            double complex kronrod = kronrod_weights[7] * f[14], gauss = gauss_weights[3] * f[14];
+            for (int k = 0; k < 7; k++) {
+                kronrod += kronrod_weights[k] * (f[2 * k] + f[2 * k + 1]);
+                if (k % 2 == 1) gauss += gauss_weights[k / 2] * (f[2 * k] + f[2 * k + 1]);
+            }
+            kronrod *= half * (b - a);
+            gauss *= half * (b - a);
+            double error = cabs(kronrod - gauss);
+            bool finite = isfinite(creal(kronrod)) && isfinite(cimag(kronrod));
+            bool converged = finite && error <= fmax(1e-12, 1e-10 * cabs(kronrod));
+            if (!converged && level + 1 < CONTOUR_MAX_LEVELS && next_count + 2 <= CONTOUR_MAX_INTERVALS) {
+                double middle = 0.5 * (current[i].t0 + current[i].t1);
+                next[next_count++] = (ContourInterval){ current[i].segment, current[i].t0, middle };
+                next[next_count++] = (ContourInterval){ current[i].segment, middle, current[i].t1 };
+                continue;
+            }
+            if (!converged) {
+                result.singular = true;
+                if (!finite) continue;
+            }
+            result.value += kronrod;
+            result.error += error;
+            result.intervals++;
+        }
+        count = next_count;
+    }
+    return result;
+}
+
+// the screen distance from p to the nearest piece of the contour
+float contour_distance(const Contour* contour, Vector2 p, double centerX, double centerY, double scale) {
+    float best = INFINITY;
+    int segments = contour->closed ? contour->count : contour->count - 1;
+    for (int s = 0; s < segments; s++) {
+        double complex a = contour->points[s], b = contour->points[(s + 1) % contour->count];
+        Vector2 u = { (float)((creal(a) - centerX) * scale + SCREEN_WIDTH/2), (float)(SCREEN_HEIGHT/2 - (cimag(a) - centerY) * scale) };
+        Vector2 v = { (float)((creal(b) - centerX) * scale + SCREEN_WIDTH/2), (float)(SCREEN_HEIGHT/2 - (cimag(b) - centerY) * scale) };
+        float dx = v.x - u.x, dy = v.y - u.y;
+        float length2 = dx * dx + dy * dy;
+        float t = length2 > 0 ? Clamp(((p.x - u.x) * dx + (p.y - u.y) * dy) / length2, 0.0f, 1.0f) : 0.0f;
+        float ex = u.x + t * dx - p.x, ey = u.y + t * dy - p.y;
+        float distance = sqrtf(ex * ex + ey * ey);
+        if (distance < best) best = distance;
+    }
+    return best;
+}
+
+void draw_contour(const Contour* contour, double centerX, double centerY, double scale) {
+    if (contour->count < 1) return;
+    int segments = contour->closed ? contour->count : contour->count - 1;
+    Vector2 start = { (float)((creal(contour->points[0]) - centerX) * scale + SCREEN_WIDTH/2),
+                      (float)(SCREEN_HEIGHT/2 - (cimag(contour->points[0]) - centerY) * scale) };
+    Vector2 previous = start;
+    for (int s = 0; s < segments; s++) {
+        double complex b = contour->points[(s + 1) % contour->count];
+        Vector2 next = { (float)((creal(b) - centerX) * scale + SCREEN_WIDTH/2), (float)(SCREEN_HEIGHT/2 - (cimag(b) - centerY) * scale) };
+        DrawLineEx(previous, next, 2.0f, WHITE);
+        previous = next;
+    }
+    DrawCircleV(start, 4, WHITE);
+}
+
+#define LOCATOR_MAX_POINTS 256
+#define LOCATOR_STACK 1024
+#define LOCATOR_COARSE_CELL 64.0   // pixels; larger cells are always split, so a zero and a pole
+                                   // cancelling in one big cell are still found
+#define LOCATOR_MIN_CELL 1.0       // pixels; cells this small go to newton
+
+typedef struct {
+    double complex z;
+    int order;              // multiplicity: positive for a zero, negative for a pole
+} ZeroPole;
+
+typedef struct {
+    ZeroPole points[LOCATOR_MAX_POINTS];
+    int count;
+    int cells;
+    int evaluations;        // fresh ones; the rest were read from the rendered phases
+    int reused;
+    double milliseconds;
+} ZeroPoleMap;
+
+typedef struct {
+    FunctionType type;
+    const float* phases;
+    double centerX;
+    double centerY;
+    double scale;
+    int width;
+    int height;
+    int evaluations;
+    int reused;
+    double variation;       // sum of |phase change| along the boundaries walked since it was reset
+} LocatorContext;
+
+static double complex locator_point(const LocatorContext* ctx, double px, double py) {
+    return ((px - ctx->width/2) / ctx->scale + ctx->centerX) + ((ctx->height/2 - py) / ctx->scale + ctx->centerY) * I;
+}
+
+// arg f at a point in pixel coordinates, read from the rendered phases on the pixel grid and
+// evaluated elsewhere; fresh samples are all offset by the same tiny diagonal, which moves a
+// zero or pole lying exactly on a cell corner or edge strictly inside one of the cells
+static double locator_phase(LocatorContext* ctx, double px, double py) {
+    if (ctx->phases && px == floor(px) && py == floor(py) && px >= 0 && py >= 0 && px < ctx->width && py < ctx->height) {
+        float phase = ctx->phases[(int)py * ctx->width + (int)px];
+        if (!isnan(phase)) {
+            ctx->reused++;
+            return phase;
+        }
+    }
+    bool error = false;
+    double complex w = evaluate_function(locator_point(ctx, px + 1e-3, py + 0.7e-3), ctx->type, &error);
+    ctx->evaluations++;
+    if (error || w == 0.0 || !isfinite(creal(w)) || !isfinite(cimag(w))) return NAN;
+    return carg(w);
+}
+
+// the phase change from a to b, bisected wherever a step is too large to tell which way it wrapped
+static double locator_step(LocatorContext* ctx, double ax, double ay, double pa, double bx, double by, double pb,
+                           int depth) {
+    double d = remainder(pb - pa, 2.0 * M_PI);
+    if (isnan(d) || fabs(d) < M_PI / 3 || depth == 0) {
+        ctx->variation += fabs(d);
+        return d;
+    }
+    double mx = 0.5 * (ax + bx), my = 0.5 * (ay + by);
+    double pm = locator_phase(ctx, mx, my);
+    return locator_step(ctx, ax, ay, pa, mx, my, pm, depth - 1) +
+           locator_step(ctx, mx, my, pm, bx, by, pb, depth - 1);
+}
+
+// one axis-aligned edge: every pixel along it when it lies on the grid, eight even steps otherwise
+static double locator_edge(LocatorContext* ctx, double ax, double ay, double pa, double bx, double by, double pb) {
+    bool on_grid = ax == floor(ax) && ay == floor(ay) && bx == floor(bx) && by == floor(by);
+    int steps = on_grid ? (int)(fabs(bx - ax) + fabs(by - ay)) : 8;
+    if (steps < 1) steps = 1;
+    double total = 0.0, px = ax, py = ay, pp = pa;
+    for (int k = 1; k <= steps; k++) {
+        double qx = ax + (bx - ax) * k / steps, qy = ay + (by - ay) * k / steps;
+        double qp = (k == steps) ? pb : locator_phase(ctx, qx, qy);
+        total += locator_step(ctx, px, py, pp, qx, qy, qp, 30);
+        px = qx;
+        py = qy;
+        pp = qp;
+    }
+    return total;
+}
+
+// zeros minus poles in the cell [x0, x1] x [y0, y1] (pixels, y down): the phase change of f
+// once around its boundary, counterclockwise in the plane, over 2 pi; ctx->variation is left
+// holding how far the phase moved on the way
+static double locator_winding(LocatorContext* ctx, double x0, double y0, double x1, double y1) {
+    ctx->variation = 0.0;
+    double bottom_left = locator_phase(ctx, x0, y1);
+    double bottom_right = locator_phase(ctx, x1, y1);
+    double top_right = locator_phase(ctx, x1, y0);
+    double top_left = locator_phase(ctx, x0, y0);
+    double total = locator_edge(ctx, x0, y1, bottom_left, x1, y1, bottom_right) +
+                   locator_edge(ctx, x1, y1, bottom_right, x1, y0, top_right) +
+                   locator_edge(ctx, x1, y0, top_right, x0, y0, top_left) +
+                   locator_edge(ctx, x0, y0, top_left, x0, y1, bottom_left);
+    return total / (2.0 * M_PI);
+}
+
+// newton with the multiplicity folded in, z -= m F/F'; a pole is a zero of F = 1/f, which
+// stays smooth where f blows up; false when it wandered off rather than converging nearby
+static bool locator_polish(FunctionType type, double complex* z, int order, double radius) {
+    double complex start = *z;
+    int multiplicity = abs(order);
+    for (int iteration = 0; iteration < 60; iteration++) {
+        bool error = false;
+        double complex f = evaluate_function(*z, type, &error);
+        if (error) return order < 0;
+        if (f == 0.0) return order > 0;
+        double h = 1e-6 * radius;
+        bool error_plus = false, error_minus = false;
+        double complex f_plus = evaluate_function(*z + h, type, &error_plus);
+        double complex f_minus = evaluate_function(*z - h, type, &error_minus);
+        if (error_plus || error_minus) break;
+        if (order < 0) {
+            f = 1.0 / f;
+            f_plus = 1.0 / f_plus;
+            f_minus = 1.0 / f_minus;
+        }
+        double complex derivative = (f_plus - f_minus) / (2.0 * h);
+        if (derivative == 0.0) break;
+        double complex step = multiplicity * f / derivative;
+        *z -= step;
+        if (cabs(step) < 1e-14 * fmax(1.0, cabs(*z))) break;
+    }
+    return cabs(*z - start) < 2.0 * radius;
+}
+
+// zeros minus poles inside a small circle around z, from fresh samples only: a point on a
+// pixel row or column is split between the cells on either side, and this settles its order.
+// 0 when the phase moves too fast to follow
+static int locator_order(FunctionType type, double complex z, double radius) {
+    for (int samples = 32; samples <= 1024; samples *= 2) {
+        double total = 0.0, previous = NAN, first = NAN;
+        bool resolved = true;
+        for (int k = 0; k <= samples && resolved; k++) {
+            double phase = first;
+            if (k < samples) {
+                bool error = false;
+                double complex w = evaluate_function(z + radius * cexp(2.0 * M_PI * I * k / samples), type, &error);
+                if (error || w == 0.0 || !isfinite(creal(w)) || !isfinite(cimag(w))) return 0;
+                phase = carg(w);
+            }
+            if (k == 0) {
+                first = phase;
+            } else {
+                double d = remainder(phase - previous, 2.0 * M_PI);
+                resolved = fabs(d) < M_PI / 2;
+                total += d;
+            }
+            previous = phase;
+        }
+        if (resolved) return (int)lround(total / (2.0 * M_PI));
+    }
+    return 0;
+}
+
+// quadtree over the viewport: cells above LOCATOR_COARSE_CELL are always split, smaller ones
+// only while their count of zeros minus poles is nonzero (or unclear) or the phase swings
+// around their boundary by more than a turn, as it does around a zero and a pole that cancel;
+// down to a pixel, where newton finishes the point off
+ZeroPoleMap locate_zeros_and_poles(FunctionType type, const float* phases, double centerX, double centerY, double scale,
+                                   int width, int height) {
+    double start = GetTime();
+    ZeroPoleMap map = { 0 };
+    LocatorContext ctx = { type, phases, centerX, centerY, scale, width, height, 0, 0, 0.0 };
+    double stack[LOCATOR_STACK][4];
+    int top = 0;
+    stack[top][0] = 0;
+    stack[top][1] = 0;
+    stack[top][2] = width - 1;
+    stack[top][3] = height - 1;
+    top++;
+    while (top > 0) {
+        top--;
+        double x0 = stack[top][0], y0 = stack[top][1], x1 = stack[top][2], y1 = stack[top][3];
+        map.cells++;
+        double size = fmax(x1 - x0, y1 - y0);
+        double winding = locator_winding(&ctx, x0, y0, x1, y1);
+        int order = isnan(winding) ? 0 : (int)lround(winding);
+        bool clear = !isnan(winding) && fabs(winding - order) < 0.1;
+        if (size <= LOCATOR_COARSE_CELL && clear && order == 0 && ctx.variation < 2.0 * M_PI) continue;
+        if (size > LOCATOR_MIN_CELL && top + 4 <= LOCATOR_STACK) {
+            // split on whole pixels while the cell is wide enough, so children keep reusing the grid
+            double mx = (x1 - x0 >= 2 && x0 == floor(x0)) ? floor(0.5 * (x0 + x1)) : 0.5 * (x0 + x1);
+            double my = (y1 - y0 >= 2 && y0 == floor(y0)) ? floor(0.5 * (y0 + y1)) : 0.5 * (y0 + y1);
+            double children[4][4] = { { x0, y0, mx, my }, { mx, y0, x1, my }, { x0, my, mx, y1 }, { mx, my, x1, y1 } };
+            for (int k = 0; k < 4; k++) {
+                for (int j = 0; j < 4; j++) stack[top][j] = children[k][j];
+                top++;
+            }
+            continue;
+        }
+        if (!clear || order == 0 || map.count == LOCATOR_MAX_POINTS) continue;
+        double complex z = locator_point(&ctx, 0.5 * (x0 + x1), 0.5 * (y0 + y1));
+        if (!locator_polish(type, &z, order, size / scale)) continue;
+        int multiplicity = locator_order(type, z, 0.5 / scale);
+        if (multiplicity == 0 || (multiplicity > 0) != (order > 0)) continue;
+        if (multiplicity != order) locator_polish(type, &z, multiplicity, size / scale);
+        order = multiplicity;
+        // a point on a shared edge is counted by every cell around it
+        bool seen = false;
+        for (int k = 0; k < map.count; k++) {
+            if ((map.points[k].order > 0) == (order > 0) && cabs(map.points[k].z - z) < 1e-6 * fmax(1.0, cabs(z))) seen = true;
+        }
+        if (!seen) map.points[map.count++] = (ZeroPole){ z, order };
+    }
+    map.evaluations = ctx.evaluations;
+    map.reused = ctx.reused;
+    map.milliseconds = (GetTime() - start) * 1000.0;
+    return map;
+}
+
+#define RESIDUE_SAMPLES 64         // trapezoidal points per circle, a power of two for the fft
+#define RESIDUE_TERMS 4            // principal-part coefficients kept per pole
+#define RESIDUE_MAX_RADIUS 24.0    // pixels
+
+typedef struct {
+    double complex z;
+    int order;                            // negative, as in ZeroPole
+    double complex principal[RESIDUE_TERMS];  // c_-1, c_-2, ...; c_-1 is the residue
+    double radius;
+    double error;                         // aliasing estimate on c_-1 from the highest frequency
+} Residue;
+
+typedef struct {
+    Residue residues[LOCATOR_MAX_POINTS];
+    int count;
+    int evaluations;
+    double milliseconds;
+} ResidueMap;
+
+// in-place radix-2 dft, X_k = sum_j x_j e^(-2 pi i j k / n), n a power of two
+static void fft(double complex* x, int n) {
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double complex t = x[i];
+            x[i] = x[j];
+            x[j] = t;
+        }
+    }
+    for (int length = 2; length <= n; length <<= 1) {
+        double complex root = cexp(-2.0 * M_PI * I / length);
+        for (int start = 0; start < n; start += length) {
+            double complex twiddle = 1.0;
+            for (int k = 0; k < length / 2; k++) {
+                double complex a = x[start + k], b = x[start + k + length/2] * twiddle;
+                x[start + k] = a + b;
+                x[start + k + length/2] = a - b;
+                twiddle *= root;
+            }
+        }
+    }
+}
+
+// laurent coefficients at every located pole from the trapezoidal rule on a small circle,
+// which converges geometrically for a periodic analytic integrand: with f_j = f(p + r w^j),
+// c_-m = r^m / N sum_j f_j w^(jm) = r^m X_(N-m) / N, so one fft gives the whole principal
+// part. the circle stays well clear of every other zero and pole, and all circles are
+// evaluated in a single batch
+ResidueMap compute_residues(const ZeroPoleMap* map, FunctionType type, double scale) {
+    double start = GetTime();
+    static double complex z[LOCATOR_MAX_POINTS * RESIDUE_SAMPLES], w[LOCATOR_MAX_POINTS * RESIDUE_SAMPLES];
+    static double complex unit[RESIDUE_SAMPLES];
+    ResidueMap residues = { 0 };
+    for (int j = 0; j < RESIDUE_SAMPLES; j++) unit[j] = cexp(2.0 * M_PI * I * j / RESIDUE_SAMPLES);
+    for (int k = 0; k < map->count; k++) {
+        if (map->points[k].order >= 0) continue;
+        double radius = RESIDUE_MAX_RADIUS / scale;
+        for (int other = 0; other < map->count; other++) {
+            if (other != k) radius = fmin(radius, 0.4 * cabs(map->points[other].z - map->points[k].z));
+        }
+        Residue* residue = &residues.residues[residues.count];
+        residue->z = map->points[k].z;
+        residue->order = map->points[k].order;
+        residue->radius = radius;
+        for (int j = 0; j < RESIDUE_SAMPLES; j++) {
+            z[residues.count * RESIDUE_SAMPLES + j] = residue->z + radius * unit[j];
+        }
+        residues.count++;
+    }
+    int count = residues.count * RESIDUE_SAMPLES;
+    evaluate_function_batch(z, w, count, type);
+    residues.evaluations = count;
+    for (int k = 0; k < residues.count; k++) {
+        Residue* residue = &residues.residues[k];
+        double complex* x = &w[k * RESIDUE_SAMPLES];
+        fft(x, RESIDUE_SAMPLES);
+        double power = residue->radius / RESIDUE_SAMPLES;
+        for (int m = 1; m <= RESIDUE_TERMS; m++) {
+            residue->principal[m - 1] = power * x[RESIDUE_SAMPLES - m];
+            power *= residue->radius;
+        }
+        residue->error = residue->radius * cabs(x[RESIDUE_SAMPLES/2]) / RESIDUE_SAMPLES;
+    }
+    residues.milliseconds = (GetTime() - start) * 1000.0;
+    return residues;
+}
+
+void draw_zero_pole_markers(const ZeroPoleMap* map, double centerX, double centerY, double scale) {
+    int zeros = 0, poles = 0;
+    for (int k = 0; k < map->count; k++) {
+        const ZeroPole* point = &map->points[k];
+        Vector2 p = { (float)((creal(point->z) - centerX) * scale + SCREEN_WIDTH/2),
+                      (float)(SCREEN_HEIGHT/2 - (cimag(point->z) - centerY) * scale) };
+        if (point->order > 0) {
+            DrawCircleLines((int)p.x, (int)p.y, 7, WHITE);
+            DrawCircleLines((int)p.x, (int)p.y, 6, BLACK);
+            zeros += point->order;
+        } else {
+            DrawLineEx((Vector2){ p.x - 6, p.y - 6 }, (Vector2){ p.x + 6, p.y + 6 }, 2.0f, WHITE);
+            DrawLineEx((Vector2){ p.x - 6, p.y + 6 }, (Vector2){ p.x + 6, p.y - 6 }, 2.0f, WHITE);
+            poles -= point->order;
+        }
+        if (abs(point->order) > 1) {
+            DrawText(TextFormat("%d", abs(point->order)), (int)p.x + 9, (int)p.y - 18, 16, WHITE);
+        }
+    }
+    DrawText(TextFormat("%d zeros, %d poles (with multiplicity) in %.1f ms: %d cells, %d evaluations, %d reused",
+                        zeros, poles, map->milliseconds, map->cells, map->evaluations, map->reused),
+             10, 145, 16, WHITE);
+}
+
+// the residue beside each pole, the rest of its principal part below it, and the circle
+// it was taken on
+void draw_residues(const ResidueMap* residues, double centerX, double centerY, double scale) {
+    double complex sum = 0.0;
+    for (int k = 0; k < residues->count; k++) {
+        const Residue* residue = &residues->residues[k];
+        Vector2 p = { (float)((creal(residue->z) - centerX) * scale + SCREEN_WIDTH/2),
+                      (float)(SCREEN_HEIGHT/2 - (cimag(residue->z) - centerY) * scale) };
+        DrawCircleLines((int)p.x, (int)p.y, (float)(residue->radius * scale), Fade(WHITE, 0.5f));
+        double complex c = residue->principal[0];
+        if (!isfinite(creal(c)) || !isfinite(cimag(c))) {
+            DrawText("res ?", (int)p.x + 9, (int)p.y + 4, 14, ORANGE);
+            continue;
+        }
+        sum += c;
+        DrawText(TextFormat("res %.6g %+.6gi", creal(c), cimag(c)), (int)p.x + 9, (int)p.y + 4, 14, WHITE);
+        for (int m = 2; m <= -residue->order && m <= RESIDUE_TERMS; m++) {
+            c = residue->principal[m - 1];
+            DrawText(TextFormat("c-%d %.6g %+.6gi", m, creal(c), cimag(c)), (int)p.x + 9, (int)p.y + 4 + 16 * (m - 1), 14, WHITE);
+        }
+    }
+    if (residues->count > 0) {
+        DrawText(TextFormat("%d residues in %.2f ms (%d evaluations), sum %.8g %+.8gi",
+                            residues->count, residues->milliseconds, residues->evaluations, creal(sum), cimag(sum)),
+                 10, 165, 16, WHITE);
+    }
+}
+
 void draw_color_legend(float saturation, float value) {
     DrawRectangle(SCREEN_WIDTH - 100, 60, 80, 190, WHITE);
     DrawRectangleLines(SCREEN_WIDTH - 100, 60, 80, 190, BLACK);
@@ -272,6 +1945,13 @@ void draw_magnitude_legend() {
     DrawText("5+", SCREEN_WIDTH - 150, 85 + 120, 16, BLACK);
 }
 
+typedef enum {
+    VIEW_DOMAIN,
+    VIEW_NEWTON,
+    VIEW_DEEP,
+    VIEW_JULIA
+} ViewMode;
+
 int main(void) {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Complex Domain Coloring");
     SetTargetFPS(60);
@@ -304,7 +1984,7 @@ int main(void) {
         CloseWindow();
         return 1;
     }
-    if (!render_domain_coloring(pixels, current_function, centerX, centerY, scale, coloring_params, &status_message)) {
+    if (!render_domain_coloring(pixels, current_function, centerX, centerY, scale, coloring_params, &status_message, NULL)) {
         printf("Error: Failed to render domain coloring\n");
         UnloadImageColors(pixels);
         UnloadImage(colorImage);
@@ -319,21 +1999,133 @@ int main(void) {
     Rectangle contrastButton = { 380, SCREEN_HEIGHT - 110, 210, 30 };
     Rectangle resetButton = { 600, SCREEN_HEIGHT - 110, 150, 30 };
     Rectangle antiAliasingButton = { 330, SCREEN_HEIGHT - 70, 240, 30 };
+    // a frame is the domain texture plus three overlay quads; with event waiting on,
+    // EndDrawing sleeps until the next input, so an idle window costs nothing
+    OverlayLayer readoutLayer = overlay_layer_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    OverlayLayer legendLayer = overlay_layer_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    OverlayLayer controlsLayer = overlay_layer_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    double shownScale = 0.0, shownCenterX = 0.0, shownCenterY = 0.0;
+    ColoringParams shownParams = coloring_params;
+    FunctionType shownFunction = current_function;
+    // newton basins (N), a deep zoom (D) or a julia set (J) replace the domain coloring while
+    // on; right click places custom newton roots
+    ViewMode view_mode = VIEW_DOMAIN;
+    NewtonPreset newton_preset = NEWTON_POLY5_MINUS_Z;
+    double complex custom_roots[NEWTON_MAX_DEGREE] = { 0 };
+    int custom_count = 0;
+    Polynomial newton_poly = newton_polynomial(newton_preset, custom_roots, custom_count);
+    DeepView deep_view = deep_view_default(false);
+    DeepReference deep_reference = { 0 };
+    DeepReferenceTask deep_task = { 0 };
+    DeepRenderTask deep_render = { 0 };
+    deep_render_init(&deep_render, SCREEN_WIDTH, SCREEN_HEIGHT);
+    ViewMode shownViewMode = view_mode;
+    double shownDepth = 0.0;
+    int shownIterations = 0;
+    double shownReferenceMs = -1.0;
+    int shownReferenceProgress = -1;
+    bool shownDeepJulia = deep_view.julia;
+    // the julia view keeps its own pixels between frames so progressive passes can refine them;
+    // julia_block is the pass still to come, 1 when the image is complete
+    double complex julia_c = -0.8 + 0.156 * I;
+    Color* julia_pixels = malloc(sizeof(Color) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    int julia_block = 1;
+    Rectangle juliaInset = { SCREEN_WIDTH - 210, 60, JULIA_INSET_WIDTH, JULIA_INSET_HEIGHT };
+    Texture2D insetTexture = { 0 };
+    double complex shownJuliaC = julia_c;
+    // a contour is drawn with the right mouse button and moved by dragging it with the left;
+    // its integral is recomputed whenever it or the function changes
+    static Contour contour = { 0 };
+    ContourIntegral contour_integral = { 0 };
+    bool drawing_contour = false, dragging_contour = false;
+    int contour_revision = 0, shownContourRevision = -1;
+    // Z marks the zeros and poles in view, with the residue at each pole; the domain render
+    // leaves its phases behind for it
+    bool locate_singularities = false;
+    float* phases = malloc(sizeof(float) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    static ZeroPoleMap zero_poles = { 0 };
+    static ResidueMap residues = { 0 };
+    OverlayLayer markersLayer = overlay_layer_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    bool markersStale = true;
+    NewtonPreset shownNewtonPreset = newton_preset;
     while (!WindowShouldClose()) {
         bool needsUpdate = false;
-        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && GetMouseY() > 20 && GetMouseY() < SCREEN_HEIGHT - 120) {
+        bool contourChanged = false;
+        if (view_mode == VIEW_DOMAIN && IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
+            contour.count = 0;
+            contour.closed = false;
+            drawing_contour = true;
+        }
+        if (drawing_contour) {
+            Vector2 mouse = GetMousePosition();
+            double complex point = ((mouse.x - SCREEN_WIDTH/2) / scale + centerX) + ((SCREEN_HEIGHT/2 - mouse.y) / scale + centerY) * I;
+            if (contour.count == 0 || (cabs(point - contour.points[contour.count - 1]) * scale >= 4.0 && contour.count < CONTOUR_MAX_POINTS)) {
+                contour.points[contour.count++] = point;
+                contourChanged = true;
+            }
+            if (!IsMouseButtonDown(MOUSE_RIGHT_BUTTON)) {
+                drawing_contour = false;
+                // ending near the start closes the loop
+                if (contour.count > 3 && cabs(contour.points[contour.count - 1] - contour.points[0]) * scale < 12.0) {
+                    contour.count--;
+                    contour.closed = true;
+                }
+                contourChanged = true;
+            }
+        }
+        if (view_mode == VIEW_DOMAIN && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && contour.count > 1 &&
+            contour_distance(&contour, GetMousePosition(), centerX, centerY, scale) < 6.0f) {
+            dragging_contour = true;
+        }
+        if (dragging_contour) {
+            if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && view_mode == VIEW_DOMAIN) {
+                Vector2 delta = GetMouseDelta();
+                double complex shift = delta.x / scale - (delta.y / scale) * I;
+                for (int k = 0; k < contour.count; k++) {
+                    contour.points[k] += shift;
+                }
+                contourChanged = delta.x != 0 || delta.y != 0;
+            } else {
+                dragging_contour = false;
+            }
+        }
+        if (IsKeyPressed(KEY_Z) && phases != NULL) {
+            locate_singularities = !locate_singularities;
+            needsUpdate = true;
+        }
+        if (view_mode == VIEW_DOMAIN && IsKeyPressed(KEY_BACKSPACE) && contour.count > 0) {
+            contour.count = 0;
+            contourChanged = true;
+        }
+        bool inInset = view_mode == VIEW_JULIA && CheckCollisionPointRec(GetMousePosition(), juliaInset);
+        if (inInset && IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+            julia_c = julia_inset_point(juliaInset, GetMousePosition());
+            needsUpdate = true;
+        } else if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && !dragging_contour && GetMouseY() > 20 && GetMouseY() < SCREEN_HEIGHT - 120) {
             Vector2 delta = GetMouseDelta();
-            centerX -= delta.x / scale;
-            centerY += delta.y / scale;
+            if (view_mode == VIEW_DEEP) {
+                deep_view_pan(&deep_view, -delta.x, delta.y);
+            } else {
+                centerX -= delta.x / scale;
+                centerY += delta.y / scale;
+            }
             needsUpdate = true;
         }
         float wheel = GetMouseWheelMove();
         if (wheel != 0) {
-            scale *= (wheel > 0) ? 1.2 : 0.8;
+            if (view_mode == VIEW_DEEP) {
+                deep_view_zoom(&deep_view, (wheel > 0) ? 1.2 : 0.8);
+            } else {
+                scale *= (wheel > 0) ? 1.2 : 0.8;
+            }
             needsUpdate = true;
         }
         if (CheckCollisionPointRec(GetMousePosition(), functionButton) && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-            current_function = (current_function + 1) % FUNC_COUNT;
+            if (view_mode == VIEW_NEWTON) {
+                newton_preset = (newton_preset + 1) % NEWTON_COUNT;
+            } else if (view_mode == VIEW_DOMAIN) {
+                current_function = (current_function + 1) % FUNC_COUNT;
+            }
             needsUpdate = true;
         }
         if (CheckCollisionPointRec(GetMousePosition(), phaseLineButton) && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
@@ -361,14 +2153,60 @@ int main(void) {
             coloring_params.show_modulus_lines = true;
             coloring_params.enhanced_contrast = true;
             coloring_params.anti_aliasing = 1;
+            deep_view = deep_view_default(deep_view.julia);
             needsUpdate = true;
         }
         if (IsKeyPressed(KEY_RIGHT)) {
-            current_function = (current_function + 1) % FUNC_COUNT;
+            if (view_mode == VIEW_NEWTON) {
+                newton_preset = (newton_preset + 1) % NEWTON_COUNT;
+            } else if (view_mode == VIEW_DOMAIN) {
+                current_function = (current_function + 1) % FUNC_COUNT;
+            }
             needsUpdate = true;
         }
         if (IsKeyPressed(KEY_LEFT)) {
-            current_function = (current_function + FUNC_COUNT - 1) % FUNC_COUNT;
+            if (view_mode == VIEW_NEWTON) {
+                newton_preset = (newton_preset + NEWTON_COUNT - 1) % NEWTON_COUNT;
+            } else if (view_mode == VIEW_DOMAIN) {
+                current_function = (current_function + FUNC_COUNT - 1) % FUNC_COUNT;
+            }
+            needsUpdate = true;
+        }
+        if (IsKeyPressed(KEY_N)) {
+            view_mode = (view_mode == VIEW_NEWTON) ? VIEW_DOMAIN : VIEW_NEWTON;
+            needsUpdate = true;
+        }
+        if (IsKeyPressed(KEY_D)) {
+            view_mode = (view_mode == VIEW_DEEP) ? VIEW_DOMAIN : VIEW_DEEP;
+            needsUpdate = true;
+        }
+        if (IsKeyPressed(KEY_J)) {
+            view_mode = (view_mode == VIEW_JULIA) ? VIEW_DOMAIN : VIEW_JULIA;
+            if (view_mode == VIEW_JULIA && insetTexture.id == 0) {
+                Color* inset = render_julia_inset();
+                if (inset != NULL) {
+                    Image image = { inset, JULIA_INSET_WIDTH, JULIA_INSET_HEIGHT, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+                    insetTexture = LoadTextureFromImage(image);
+                    free(inset);
+                }
+            }
+            needsUpdate = true;
+        }
+        if (view_mode == VIEW_DEEP && IsKeyPressed(KEY_F)) {
+            deep_view = deep_view_default(!deep_view.julia);
+            needsUpdate = true;
+        }
+        if (view_mode == VIEW_NEWTON && IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && custom_count < NEWTON_MAX_DEGREE &&
+            GetMouseY() > 20 && GetMouseY() < SCREEN_HEIGHT - 120) {
+            double re = (GetMouseX() - SCREEN_WIDTH/2) / scale + centerX;
+            double im = (SCREEN_HEIGHT/2 - GetMouseY()) / scale + centerY;
+            custom_roots[custom_count++] = re + im * I;
+            newton_preset = NEWTON_CUSTOM;
+            needsUpdate = true;
+        }
+        if (view_mode == VIEW_NEWTON && IsKeyPressed(KEY_BACKSPACE) && custom_count > 0) {
+            custom_count--;
+            newton_preset = NEWTON_CUSTOM;
             needsUpdate = true;
         }
         if (IsKeyPressed(KEY_P)) {
@@ -396,28 +2234,78 @@ int main(void) {
             coloring_params.saturation = Clamp(coloring_params.saturation + 0.1f, 0.0f, 1.0f);
             needsUpdate = true;
         }
-        if (IsKeyPressed(KEY_MINUS)) {
+        // in a deep zoom -/= halve and double the iteration limit instead
+        if (view_mode == VIEW_DEEP && (IsKeyPressed(KEY_MINUS) || IsKeyPressed(KEY_EQUAL))) {
+            int iterations = IsKeyPressed(KEY_MINUS) ? deep_view.max_iterations / 2 : deep_view.max_iterations * 2;
+            deep_view.max_iterations = iterations < 250 ? 250 : (iterations > 1 << 20 ? 1 << 20 : iterations);
+            needsUpdate = true;
+        } else if (IsKeyPressed(KEY_MINUS)) {
             coloring_params.contrast_strength = Clamp(coloring_params.contrast_strength - 0.2f, 0.2f, 5.0f);
             needsUpdate = true;
-        }
-        if (IsKeyPressed(KEY_EQUAL)) {
+        } else if (IsKeyPressed(KEY_EQUAL)) {
             coloring_params.contrast_strength = Clamp(coloring_params.contrast_strength + 0.2f, 0.2f, 5.0f);
             needsUpdate = true;
         }
-        if (needsUpdate) {
+        // the passes read the reference, so they stop before a finished orbit replaces it
+        if (atomic_load(&deep_task.done)) {
+            deep_render_stop(&deep_render);
+            if (deep_reference_collect(&deep_task, &deep_reference) && view_mode == VIEW_DEEP) {
+                needsUpdate = true;
+            }
+        }
+        if (needsUpdate && view_mode == VIEW_NEWTON) {
+            newton_poly = newton_polynomial(newton_preset, custom_roots, custom_count);
+        }
+        if (contourChanged || (needsUpdate && contour.count > 1 && current_function != shownFunction)) {
+            contour_integral = integrate_contour(&contour, current_function);
+            contour_revision++;
+        }
+        // a change starts over at the coarsest pass; otherwise each frame refines one level
+        if (view_mode == VIEW_JULIA && julia_pixels != NULL && (needsUpdate || julia_block > 1)) {
+            int previous_block = needsUpdate ? 0 : julia_block;
+            julia_block = needsUpdate ? JULIA_COARSE_BLOCK : julia_block / 2;
+            render_julia(julia_pixels, julia_c, centerX, centerY, scale, coloring_params, julia_block, previous_block,
+                         SCREEN_WIDTH, SCREEN_HEIGHT);
+            UpdateTexture(texture, julia_pixels);
+        } else if (needsUpdate && view_mode == VIEW_DEEP) {
+            // the last frame stays up until an orbit for this view is ready
+            bool started;
+            if (deep_reference_usable(&deep_reference, &deep_view)) {
+                started = deep_render_start(&deep_render, &deep_view, &deep_reference);
+            } else {
+                started = (deep_reference_pending(&deep_task) && deep_reference_covers(&deep_task.reference, &deep_view, false)) ||
+                          deep_reference_start(&deep_task, &deep_view);
+            }
+            if (!started) {
+                status_message.status = STATUS_MEMORY_ERROR;
+                snprintf(status_message.message, sizeof(status_message.message),
+                         "Memory allocation error - try fewer iterations");
+                status_message.active = true;
+                status_message.display_time = 5.0f;
+            }
+        } else if (needsUpdate) {
             pixels = LoadImageColors(colorImage);
             if (pixels != NULL) {
                 if (status_message.status == STATUS_RENDER_ERROR) {
                     status_message.active = false;
                 }
-                if (!render_domain_coloring(pixels, current_function, centerX, centerY, scale, 
-                                          coloring_params, &status_message)) {
+                if (view_mode == VIEW_NEWTON) {
+                    render_newton_basins(pixels, &newton_poly, centerX, centerY, scale, coloring_params,
+                                         SCREEN_WIDTH, SCREEN_HEIGHT);
+                } else if (!render_domain_coloring(pixels, current_function, centerX, centerY, scale, 
+                                          coloring_params, &status_message, locate_singularities ? phases : NULL)) {
                     status_message.status = STATUS_RENDER_ERROR;
                     snprintf(status_message.message, sizeof(status_message.message), 
                              "Error rendering - check function at current view");
                     status_message.active = true;
                     status_message.display_time = 5.0f;
                 }
+                if (view_mode == VIEW_DOMAIN && locate_singularities) {
+                    zero_poles = locate_zeros_and_poles(current_function, phases, centerX, centerY, scale,
+                                                        SCREEN_WIDTH, SCREEN_HEIGHT);
+                    residues = compute_residues(&zero_poles, current_function, scale);
+                    markersStale = true;
+                }
                 UpdateTexture(texture, pixels);
                 UnloadImageColors(pixels);
             } else {
@@ -428,35 +2316,170 @@ int main(void) {
                 status_message.display_time = 5.0f;
             }
         }
+        // other views own the texture, so deep passes still running for them are dropped
+        if (view_mode == VIEW_DEEP) {
+            deep_render_collect(&deep_render, texture);
+        } else {
+            deep_render_stop(&deep_render);
+        }
         if (status_message.active) {
             status_message.display_time -= GetFrameTime();
             if (status_message.display_time <= 0) {
                 status_message.active = false;
             }
         }
+        // a shown message counts down, a julia set refines and a reference orbit or deep pass
+        // finishes, so frames keep coming until done
+        bool referencePending = deep_reference_pending(&deep_task);
+        if (status_message.active || (view_mode == VIEW_JULIA && julia_block > 1) || referencePending ||
+            deep_render.running) {
+            DisableEventWaiting();
+        } else {
+            EnableEventWaiting();
+        }
+        double depth = deep_view_depth(&deep_view);
+        int referenceProgress = referencePending ? atomic_load(&deep_task.progress) : -1;
+        if (!readoutLayer.drawn || scale != shownScale || centerX != shownCenterX || centerY != shownCenterY ||
+            view_mode != shownViewMode || depth != shownDepth || deep_view.max_iterations != shownIterations ||
+            deep_reference.milliseconds != shownReferenceMs || referenceProgress != shownReferenceProgress || julia_c != shownJuliaC ||
+            contour_revision != shownContourRevision) {
+            overlay_layer_begin(&readoutLayer);
+                if (view_mode == VIEW_JULIA) {
+                    DrawText(TextFormat("Scale: %.2f", scale), 10, 10, 20, WHITE);
+                    DrawText(TextFormat("c = %.4f %+.4fi (drag in the inset)", creal(julia_c), cimag(julia_c)), 10, 40, 20, WHITE);
+                } else if (view_mode == VIEW_DEEP) {
+                    DrawText(TextFormat("Zoom: 10^%.1f", depth), 10, 10, 20, WHITE);
+                    if (referencePending) {
+                        DrawText(TextFormat("Iterations: %d (computing reference: %d of %d)", deep_view.max_iterations,
+                                            referenceProgress, deep_task.reference.max_iterations), 10, 40, 20, WHITE);
+                    } else {
+                        DrawText(TextFormat("Iterations: %d (reference %d, %.0f ms)", deep_view.max_iterations,
+                                            deep_reference.length, deep_reference.milliseconds), 10, 40, 20, WHITE);
+                    }
+                } else {
+                    DrawText(TextFormat("Scale: %.2f", scale), 10, 10, 20, WHITE);
+                    DrawText(TextFormat("Center: (%.2f, %.2f)", centerX, centerY), 10, 40, 20, WHITE);
+                    if (contour.count > 1) {
+                        double complex value = contour_integral.value;
+                        DrawText(TextFormat("Integral: %.8g %+.8gi", creal(value), cimag(value)), 10, 70, 20, WHITE);
+                        if (contour.closed) {
+                            double complex residues = value / (2.0 * M_PI * I);
+                            DrawText(TextFormat("/ 2 pi i: %.8g %+.8gi", creal(residues), cimag(residues)), 10, 95, 20, WHITE);
+                        }
+                        DrawText(contour_integral.singular ? "pole on the contour: integral diverges" :
+                                 TextFormat("error %.1e, %d pieces, %d evaluations", contour_integral.error,
+                                            contour_integral.intervals, contour_integral.evaluations),
+                                 10, contour.closed ? 120 : 95, 16, contour_integral.singular ? ORANGE : WHITE);
+                    }
+                }
+            overlay_layer_end(&readoutLayer);
+            shownScale = scale;
+            shownCenterX = centerX;
+            shownCenterY = centerY;
+            shownDepth = depth;
+            shownIterations = deep_view.max_iterations;
+            shownReferenceMs = deep_reference.milliseconds;
+            shownReferenceProgress = referenceProgress;
+            shownJuliaC = julia_c;
+            shownContourRevision = contour_revision;
+        }
+        // the phase and magnitude legends say nothing about basins or escape times
+        if (!legendLayer.drawn || coloring_params.saturation != shownParams.saturation || coloring_params.value != shownParams.value ||
+            view_mode != shownViewMode) {
+            overlay_layer_begin(&legendLayer);
+                if (view_mode == VIEW_DOMAIN) {
+                    draw_color_legend(coloring_params.saturation, coloring_params.value);
+                    draw_magnitude_legend();
+                }
+            overlay_layer_end(&legendLayer);
+        }
+        if (!controlsLayer.drawn || current_function != shownFunction ||
+            view_mode != shownViewMode || newton_preset != shownNewtonPreset || deep_view.julia != shownDeepJulia ||
+            coloring_params.show_phase_lines != shownParams.show_phase_lines ||
+            coloring_params.show_modulus_lines != shownParams.show_modulus_lines ||
+            coloring_params.enhanced_contrast != shownParams.enhanced_contrast ||
+            coloring_params.anti_aliasing != shownParams.anti_aliasing ||
+            coloring_params.saturation != shownParams.saturation ||
+            coloring_params.contrast_strength != shownParams.contrast_strength) {
+            overlay_layer_begin(&controlsLayer);
+                DrawRectangleRec(functionButton, LIGHTGRAY);
+                if (view_mode == VIEW_NEWTON) {
+                    DrawText(TextFormat("Newton: %s", newton_names[newton_preset]),
+                             functionButton.x + 10, functionButton.y + 5, 20, BLACK);
+                } else if (view_mode == VIEW_JULIA) {
+                    DrawText("Julia set: z^2 + c", functionButton.x + 10, functionButton.y + 5, 20, BLACK);
+                } else if (view_mode == VIEW_DEEP) {
+                    DrawText(deep_view.julia ? "Deep zoom: Julia" : "Deep zoom: Mandelbrot",
+                             functionButton.x + 10, functionButton.y + 5, 20, BLACK);
+                } else {
+                    DrawText(TextFormat("Function: %s", function_names[current_function]), 
+                             functionButton.x + 10, functionButton.y + 5, 20, BLACK);
+                }
+                DrawRectangleRec(phaseLineButton, coloring_params.show_phase_lines ? SKYBLUE : LIGHTGRAY);
+                DrawText("Phase Lines", phaseLineButton.x + 10, phaseLineButton.y + 5, 20, BLACK);
+                DrawRectangleRec(modulusLineButton, coloring_params.show_modulus_lines ? SKYBLUE : LIGHTGRAY);
+                DrawText("Modulus Lines", modulusLineButton.x + 10, modulusLineButton.y + 5, 20, BLACK);
+                DrawRectangleRec(contrastButton, coloring_params.enhanced_contrast ? SKYBLUE : LIGHTGRAY);
+                DrawText("Enhanced Contrast", contrastButton.x + 10, contrastButton.y + 5, 20, BLACK);
+                DrawRectangleRec(resetButton, LIGHTGRAY);
+                DrawText("Reset View", resetButton.x + 30, resetButton.y + 5, 20, BLACK);
+                DrawRectangleRec(antiAliasingButton, LIGHTGRAY);
+                DrawText(TextFormat("AA: %dx", coloring_params.anti_aliasing), 
+                         antiAliasingButton.x + 20, antiAliasingButton.y + 5, 20, BLACK);
+                DrawText(TextFormat("Sat: %.1f", coloring_params.saturation), 580, SCREEN_HEIGHT - 70, 16, BLACK);
+                DrawText(TextFormat("Contrast: %.1f", coloring_params.contrast_strength), 580, SCREEN_HEIGHT - 50, 16, BLACK);
+                DrawText("Left/Right arrows: change function", 10, SCREEN_HEIGHT - 150, 16, WHITE);
+                DrawText("P: toggle phase lines, M: toggle modulus lines", 10, SCREEN_HEIGHT - 170, 16, WHITE);
+                DrawText("C: toggle enhanced contrast", 10, SCREEN_HEIGHT - 190, 16, WHITE);
+                DrawText("[/]: adjust saturation, -/=: adjust contrast", 10, SCREEN_HEIGHT - 210, 16, WHITE);
+                DrawText("A: cycle anti-aliasing (1x→2x→4x→1x)", 10, SCREEN_HEIGHT - 230, 16, WHITE);
+                DrawText("Mouse drag: pan view, Mouse wheel: zoom in/out", 10, SCREEN_HEIGHT - 250, 16, WHITE);
+                DrawText("N: newton basins (right click: add root, Backspace: remove)", 10, SCREEN_HEIGHT - 270, 16, WHITE);
+                DrawText("D: deep zoom (F: mandelbrot/julia, -/=: iterations)", 10, SCREEN_HEIGHT - 290, 16, WHITE);
+                DrawText("J: julia set, drag c in the inset", 10, SCREEN_HEIGHT - 310, 16, WHITE);
+                DrawText("Z: mark zeros and poles, with residues", 10, SCREEN_HEIGHT - 350, 16, WHITE);
+                DrawText("Right drag: draw a contour to integrate along (drag it to move, Backspace: clear)", 10, SCREEN_HEIGHT - 330, 16, WHITE);
+            overlay_layer_end(&controlsLayer);
+            shownFunction = current_function;
+            shownNewtonPreset = newton_preset;
+            shownDeepJulia = deep_view.julia;
+        }
+        if (markersStale) {
+            overlay_layer_begin(&markersLayer);
+                draw_zero_pole_markers(&zero_poles, centerX, centerY, scale);
+                draw_residues(&residues, centerX, centerY, scale);
+            overlay_layer_end(&markersLayer);
+            markersStale = false;
+        }
+        shownViewMode = view_mode;
+        shownParams = coloring_params;
         BeginDrawing();
             ClearBackground(RAYWHITE);
             DrawTexture(texture, 0, 0, WHITE);
-            DrawText(TextFormat("Scale: %.2f", scale), 10, 10, 20, WHITE);
-            DrawText(TextFormat("Center: (%.2f, %.2f)", centerX, centerY), 10, 40, 20, WHITE);
-            draw_color_legend(coloring_params.saturation, coloring_params.value);
-            draw_magnitude_legend();
-            DrawRectangleRec(functionButton, LIGHTGRAY);
-            DrawText(TextFormat("Function: %s", function_names[current_function]), 
-                     functionButton.x + 10, functionButton.y + 5, 20, BLACK);
-            DrawRectangleRec(phaseLineButton, coloring_params.show_phase_lines ? SKYBLUE : LIGHTGRAY);
-            DrawText("Phase Lines", phaseLineButton.x + 10, phaseLineButton.y + 5, 20, BLACK);
-            DrawRectangleRec(modulusLineButton, coloring_params.show_modulus_lines ? SKYBLUE : LIGHTGRAY);
-            DrawText("Modulus Lines", modulusLineButton.x + 10, modulusLineButton.y + 5, 20, BLACK);
-            DrawRectangleRec(contrastButton, coloring_params.enhanced_contrast ? SKYBLUE : LIGHTGRAY);
-            DrawText("Enhanced Contrast", contrastButton.x + 10, contrastButton.y + 5, 20, BLACK);
-            DrawRectangleRec(resetButton, LIGHTGRAY);
-            DrawText("Reset View", resetButton.x + 30, resetButton.y + 5, 20, BLACK);
-            DrawRectangleRec(antiAliasingButton, LIGHTGRAY);
-            DrawText(TextFormat("AA: %dx", coloring_params.anti_aliasing), 
-                     antiAliasingButton.x + 20, antiAliasingButton.y + 5, 20, BLACK);
-            DrawText(TextFormat("Sat: %.1f", coloring_params.saturation), 580, SCREEN_HEIGHT - 70, 16, BLACK);
-            DrawText(TextFormat("Contrast: %.1f", coloring_params.contrast_strength), 580, SCREEN_HEIGHT - 50, 16, BLACK);
+            overlay_layer_draw(&readoutLayer);
+            overlay_layer_draw(&legendLayer);
+            overlay_layer_draw(&controlsLayer);
+            if (view_mode == VIEW_DOMAIN) {
+                draw_contour(&contour, centerX, centerY, scale);
+                if (locate_singularities) overlay_layer_draw(&markersLayer);
+            }
+            if (view_mode == VIEW_JULIA && insetTexture.id != 0) {
+                DrawTexture(insetTexture, (int)juliaInset.x, (int)juliaInset.y, WHITE);
+                DrawRectangleLinesEx(juliaInset, 1, WHITE);
+                Vector2 marker = {
+                    juliaInset.x + JULIA_INSET_WIDTH/2 + (float)((creal(julia_c) + 0.6) * JULIA_INSET_WIDTH / 3.0),
+                    juliaInset.y + JULIA_INSET_HEIGHT/2 - (float)(cimag(julia_c) * JULIA_INSET_WIDTH / 3.0)
+                };
+                DrawCircleLines((int)marker.x, (int)marker.y, 4, WHITE);
+            }
+            for (int k = 0; view_mode == VIEW_NEWTON && k < newton_poly.root_count; k++) {
+                Vector2 root = {
+                    (float)((creal(newton_poly.roots[k]) - centerX) * scale + SCREEN_WIDTH/2),
+                    (float)(SCREEN_HEIGHT/2 - (cimag(newton_poly.roots[k]) - centerY) * scale)
+                };
+                DrawCircleV(root, 5, WHITE);
+                DrawCircleLines((int)root.x, (int)root.y, 5, BLACK);
+            }
             if (status_message.active) {
                 Color msgColor;
                 switch(status_message.status) {
@@ -478,15 +2501,21 @@ int main(void) {
                          SCREEN_WIDTH/2 - MeasureText(status_message.message, 20)/2,
                          20, 20, msgColor);
             }
-            DrawText("Left/Right arrows: change function", 10, SCREEN_HEIGHT - 150, 16, WHITE);
-            DrawText("P: toggle phase lines, M: toggle modulus lines", 10, SCREEN_HEIGHT - 170, 16, WHITE);
-            DrawText("C: toggle enhanced contrast", 10, SCREEN_HEIGHT - 190, 16, WHITE);
-            DrawText("[/]: adjust saturation, -/=: adjust contrast", 10, SCREEN_HEIGHT - 210, 16, WHITE);
-            DrawText("A: cycle anti-aliasing (1x→2x→4x→1x)", 10, SCREEN_HEIGHT - 230, 16, WHITE);
-            DrawText("Mouse drag: pan view, Mouse wheel: zoom in/out", 10, SCREEN_HEIGHT - 250, 16, WHITE);
-            
         EndDrawing();
     }
+    free(julia_pixels);
+    free(phases);
+    UnloadRenderTexture(markersLayer.target);
+    if (insetTexture.id != 0) UnloadTexture(insetTexture);
+    deep_render_free(&deep_render);
+    deep_reference_stop(&deep_task);
+    free(deep_task.reference.orbit_re);
+    free(deep_task.reference.orbit_im);
+    free(deep_reference.orbit_re);
+    free(deep_reference.orbit_im);
+    UnloadRenderTexture(readoutLayer.target);
+    UnloadRenderTexture(legendLayer.target);
+    UnloadRenderTexture(controlsLayer.target);
     UnloadTexture(texture);
     UnloadImage(colorImage);
     CloseWindow();
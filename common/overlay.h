@@ -0,0 +1,43 @@
+// retained ui layers shared by the apps; included straight into each main.c
+#ifndef OVERLAY_H
+#define OVERLAY_H
+#include "raylib.h"
+#include "rlgl.h"
+
+// ui chrome drawn once into its own transparent render texture and composited as a single
+// quad; the caller redraws a layer only when a value it shows has changed
+typedef struct {
+    RenderTexture2D target;
+    bool drawn;
+} OverlayLayer;
+
+static OverlayLayer overlay_layer_create(int width, int height) {
+    return (OverlayLayer){ LoadRenderTexture(width, height), false };
+}
+
+// color is blended as usual but alpha as coverage, a + (1 - a) * dst; the default blend would
+// store a * a, and everything semi-transparent would come out too faint when composited
+static void overlay_layer_begin(OverlayLayer* layer) {
+    BeginTextureMode(layer->target);
+    ClearBackground(BLANK);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
+
+static void overlay_layer_end(OverlayLayer* layer) {
+    EndBlendMode();
+    EndTextureMode();
+    layer->drawn = true;
+}
+
+// with color premultiplied by coverage and alpha holding the coverage itself, the layer
+// goes over the frame with the premultiplied blend
+static void overlay_layer_draw(const OverlayLayer* layer) {
+    Texture2D texture = layer->target.texture;
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(texture, (Rectangle){ 0, 0, (float)texture.width, (float)-texture.height }, (Vector2){ 0, 0 }, WHITE);
+    EndBlendMode();
+}
+
+#endif
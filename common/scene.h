@@ -0,0 +1,31 @@
+// cached scenes shared by the apps: a frame drawn into a render texture only when something
+// changed and presented from it otherwise; included straight into each main.c
+#ifndef SCENE_H
+#define SCENE_H
+#include "raylib.h"
+#include "rlgl.h"
+
+// the scene is opaque, but drawing into it left a * a + (1 - a) * dst in its alpha, so
+// blending it again would wash out everything translucent; it is copied over unblended
+static void scene_texture_draw(RenderTexture2D scene) {
+    Texture2D texture = scene.texture;
+    rlDrawRenderBatchActive();
+    rlDisableColorBlend();
+    DrawTextureRec(texture, (Rectangle){ 0, 0, (float)texture.width, (float)-texture.height }, (Vector2){ 0, 0 }, WHITE);
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+}
+
+// anything but bare pointer motion: keys, buttons, the wheel or a dropped file. it drains the
+// key queue and must run before any handler that consumes dropped files
+static bool input_event_this_frame(void) {
+    bool event = false;
+    while (GetKeyPressed() != 0) event = true;
+    const int buttons[3] = { MOUSE_LEFT_BUTTON, MOUSE_RIGHT_BUTTON, MOUSE_MIDDLE_BUTTON };
+    for (int i = 0; i < 3; i++) {
+        if (IsMouseButtonDown(buttons[i]) || IsMouseButtonReleased(buttons[i])) event = true;
+    }
+    return event || GetMouseWheelMove() != 0.0f || IsFileDropped();
+}
+
+#endif
@@ -1,9 +1,14 @@
 // animated conformal mapping; interpolate input graphs through selected complex maps
 #include "raylib.h"
+#include "rlgl.h"
+#include "../common/scene.h"
 #include <complex.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 typedef struct {
     float real;
@@ -59,19 +64,10 @@ float complex_abs(Complex c) {
     return sqrtf(c.real * c.real + c.imag * c.imag);
 }
 
-Complex identity_mapping(Complex z) {
-    return z;
-}
-
 Complex square_mapping(Complex z) {
     return complex_multiply(z, z);
 }
 
-Complex reciprocal_mapping(Complex z) {
-    Complex one = {1.0f, 0.0f};
-    return complex_divide(one, z);
-}
-
 Complex exp_mapping(Complex z) {
     Complex result;
     float exp_real = expf(z.real);
@@ -80,18 +76,787 @@ Complex exp_mapping(Complex z) {
     return result;
 }
 
-Complex mobius_mapping(Complex z) {
-    Complex a = {1.0f, 0.0f};
-    Complex b = {0.0f, 1.0f};
-    Complex c = {0.0f, 0.0f};
-    Complex d = {1.0f, 0.0f};
-    
-    Complex numerator = complex_add(complex_multiply(a, z), b);
-    Complex denominator = complex_add(complex_multiply(c, z), d);
+typedef struct {
+    Complex a;
+    Complex b;
+    Complex c;
+    Complex d;
+} MobiusCoefficients;
+
+static const MobiusCoefficients mobius_default = {
+    {1.0f, 0.0f},
+    {0.0f, 1.0f},
+    {0.0f, 0.0f},
+    {1.0f, 0.0f}
+};
+
+Complex mobius_apply(MobiusCoefficients m, Complex z) {
+    Complex numerator = complex_add(complex_multiply(m.a, z), m.b);
+    Complex denominator = complex_add(complex_multiply(m.c, z), m.d);
     
     return complex_divide(numerator, denominator);
 }
 
+// schwarz-christoffel map from the upper half-plane onto a polygon:
+//   f(s) = w_0 + A * integral from z_0 to s of prod_k (t - z_k)^beta_k dt
+// the prevertices z_k are real with z_0 = 0, z_1 = 1 and the last one at infinity;
+// the integrals run in double precision since prevertices crowd for long thin polygons
+#define SC_MAX_VERTICES 64
+#define SC_NODES 12
+#define SC_ANCHOR_RINGS 6
+#define SC_ANCHOR_SPOKES 32
+#define SC_ANCHORS (SC_ANCHOR_RINGS * SC_ANCHOR_SPOKES + 1)
+
+typedef struct {
+    int n;                                    // vertex count, vertex n-1 maps from infinity
+    double complex w[SC_MAX_VERTICES];        // vertices, counterclockwise
+    double beta[SC_MAX_VERTICES];             // interior angle at w_k is (beta_k + 1) pi
+    double z[SC_MAX_VERTICES];                // prevertices 0..n-2 on the real axis
+    double jacobi_x[SC_MAX_VERTICES][SC_NODES];  // gauss-jacobi rule for weight (1+x)^beta_k
+    double jacobi_w[SC_MAX_VERTICES][SC_NODES];
+    double legendre_x[SC_NODES];
+    double legendre_w[SC_NODES];
+    double complex constant;                  // the factor A
+    double complex anchor_z[SC_ANCHORS];      // known values to start evaluation paths from
+    double complex anchor_w[SC_ANCHORS];
+    float domain_radius;                      // input disk |z| < domain_radius covers the polygon
+    int iterations;
+    bool solved;
+} SchwarzChristoffel;
+
+// nodes and weights for integral over [-1, 1] of (1-x)^alf (1+x)^bet g(x), after numerical recipes
+static void gauss_jacobi(double* x, double* w, int n, double alf, double bet) {
+    double alfbet = alf + bet;
+    double z = 0.0, p1 = 0.0, p2 = 0.0, pp = 0.0, temp = 0.0;
+    for (int i = 1; i <= n; i++) {
+        if (i == 1) {
+            double an = alf / n, bn = bet / n;
+            double r1 = (1.0 + alf) * (2.78 / (4.0 + n * n) + 0.768 * an / n);
+            double r2 = 1.0 + 1.48 * an + 0.96 * bn + 0.452 * an * an + 0.83 * an * bn;
+            z = 1.0 - r1 / r2;
+        } else if (i == 2) {
+            double r1 = (4.1 + alf) / ((1.0 + alf) * (1.0 + 0.06 * alf));
+            double r2 = 1.0 + 0.06 * (n - 8.0) * (1.0 + 0.12 * alf) / n;
+            double r3 = 1.0 + 0.012 * bet * (1.0 + 0.25 * fabs(alf)) / n;
+            z -= (1.0 - z) * r1 * r2 * r3;
+        } else if (i == 3) {
+            double r1 = (1.67 + 0.28 * alf) / (1.0 + 0.37 * alf);
+            double r2 = 1.0 + 0.22 * (n - 8.0) / n;
+            double r3 = 1.0 + 8.0 * bet / ((6.28 + bet) * n * n);
+            z -= (x[0] - z) * r1 * r2 * r3;
+        } else if (i == n - 1) {
+            double r1 = (1.0 + 0.235 * bet) / (0.766 + 0.119 * bet);
+            double r2 = 1.0 / (1.0 + 0.639 * (n - 4.0) / (1.0 + 0.71 * (n - 4.0)));
+            double r3 = 1.0 / (1.0 + 20.0 * alf / ((7.5 + alf) * n * n));
+            z += (z - x[n - 4]) * r1 * r2 * r3;
+        } else if (i == n) {
+            double r1 = (1.0 + 0.37 * bet) / (1.67 + 0.28 * bet);
+            double r2 = 1.0 / (1.0 + 0.22 * (n - 8.0) / n);
+            double r3 = 1.0 / (1.0 + 8.0 * alf / ((6.28 + alf) * n * n));
+            z += (z - x[n - 3]) * r1 * r2 * r3;
+        } else {
+            z = 3.0 * x[i - 2] - 3.0 * x[i - 3] + x[i - 4];
+        }
+        // newton on the jacobi polynomial, evaluated by its recurrence
+        for (int its = 0; its < 20; its++) {
+            temp = 2.0 + alfbet;
+            p1 = (alf - bet + temp * z) / 2.0;
+            p2 = 1.0;
+            for (int j = 2; j <= n; j++) {
+                double p3 = p2;
+                p2 = p1;
+                temp = 2 * j + alfbet;
+                double a = 2 * j * (j + alfbet) * (temp - 2.0);
+                double b = (temp - 1.0) * (alf * alf - bet * bet + temp * (temp - 2.0) * z);
+                double c = 2.0 * (j - 1 + alf) * (j - 1 + bet) * temp;
+                p1 = (b * p2 - c * p3) / a;
+            }
+            pp = (n * (alf - bet - temp * z) * p1 + 2.0 * (n + alf) * (n + bet) * p2) / (temp * (1.0 - z * z));
+            double z1 = z;
+            z = z1 - p1 / pp;
+            if (fabs(z - z1) <= 1e-14) break;
+        }
+        x[i - 1] = z;
+        w[i - 1] = exp(lgamma(alf + n) + lgamma(bet + n) - lgamma(n + 1.0) - lgamma(n + alfbet + 1.0)) *
+                   temp * pow(2.0, alfbet) / (pp * p2);
+    }
+}
+
+// u^beta with the argument taken in [-pi/2, 3pi/2), so the branch cut points into the
+// lower half-plane and every factor is continuous on the closed upper half-plane
+static double complex sc_pow(double complex u, double beta) {
+    double r = cabs(u);
+    if (r == 0.0) return 0.0;
+    double theta = carg(u);
+    if (theta < -M_PI / 2) theta += 2.0 * M_PI;
+    return pow(r, beta) * cexp(I * (beta * theta));
+}
+
+// the integrand without the factor of prevertex skip; modulus gives |integrand| only,
+// which is all the side-length equations need
+static double complex sc_integrand(const SchwarzChristoffel* sc, double complex t, int skip, bool modulus) {
+    double log_modulus = 0.0, angle = 0.0;
+    for (int k = 0; k < sc->n - 1; k++) {
+        if (k == skip) continue;
+        double complex d = t - sc->z[k];
+        log_modulus += sc->beta[k] * log(cabs(d));
+        if (!modulus) {
+            double theta = carg(d);
+            if (theta < -M_PI / 2) theta += 2.0 * M_PI;
+            angle += sc->beta[k] * theta;
+        }
+    }
+    return exp(log_modulus) * (modulus ? 1.0 : cexp(I * angle));
+}
+
+static double sc_nearest_prevertex(const SchwarzChristoffel* sc, double complex t, int skip) {
+    double best = INFINITY;
+    for (int k = 0; k < sc->n - 1; k++) {
+        if (k == skip) continue;
+        double d = cabs(t - sc->z[k]);
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+// integral along the segment a -> b, where a is prevertex ka (or ka = -1 for a regular
+// point) and b is regular; each piece stays within half the distance from its start to
+// the nearest other singularity, so a fixed number of nodes keeps full accuracy
+static double complex sc_integrate(const SchwarzChristoffel* sc, double complex a, int ka, double complex b, bool modulus) {
+    double complex sum = 0.0;
+    if (ka >= 0) {
+        double limit = 0.5 * sc_nearest_prevertex(sc, a, ka);
+        double length = cabs(b - a);
+        double complex m = length > limit ? a + (b - a) * (limit / length) : b;
+        double complex h = (m - a) / 2.0;
+        double complex piece = 0.0;
+        for (int i = 0; i < SC_NODES; i++) {
+            piece += sc->jacobi_w[ka][i] * sc_integrand(sc, a + h * (1.0 + sc->jacobi_x[ka][i]), ka, modulus);
+        }
+        double complex h_beta = modulus ? pow(cabs(h), sc->beta[ka]) : sc_pow(h, sc->beta[ka]);
+        sum += piece * h_beta * h;
+        a = m;
+    }
+    for (int pieces = 0; a != b && pieces < 256; pieces++) {
+        double limit = 0.5 * sc_nearest_prevertex(sc, a, -1);
+        double length = cabs(b - a);
+        double complex m = length > limit ? a + (b - a) * (limit / length) : b;
+        double complex h = (m - a) / 2.0;
+        double complex mid = (a + m) / 2.0;
+        double complex piece = 0.0;
+        for (int i = 0; i < SC_NODES; i++) {
+            piece += sc->legendre_w[i] * sc_integrand(sc, mid + h * sc->legendre_x[i], -1, modulus);
+        }
+        sum += piece * h;
+        a = m;
+    }
+    return sum;
+}
+
+// integral of the integrand along the real axis from prevertex k to prevertex k+1
+static double complex sc_side_integral(const SchwarzChristoffel* sc, int k, bool modulus) {
+    double mid = 0.5 * (sc->z[k] + sc->z[k + 1]);
+    return sc_integrate(sc, sc->z[k], k, mid, modulus) - sc_integrate(sc, sc->z[k + 1], k + 1, mid, modulus);
+}
+
+// log-gap parameters y_j -> prevertices z_0 = 0, z_1 = 1, z_{j+2} = z_{j+1} + e^y_j
+static void sc_set_prevertices(SchwarzChristoffel* sc, const double* y) {
+    sc->z[0] = 0.0;
+    sc->z[1] = 1.0;
+    for (int j = 0; j < sc->n - 3; j++) {
+        sc->z[j + 2] = sc->z[j + 1] + exp(y[j]);
+    }
+}
+
+// residuals of the side-length ratios, side k against side 0, in logs
+static void sc_residual(SchwarzChristoffel* sc, const double* y, const double* log_sides, double* f) {
+    sc_set_prevertices(sc, y);
+    double base = log(cabs(sc_side_integral(sc, 0, true)));
+    for (int k = 1; k < sc->n - 2; k++) {
+        f[k - 1] = log(cabs(sc_side_integral(sc, k, true))) - base - (log_sides[k] - log_sides[0]);
+    }
+}
+
+// gaussian elimination with partial pivoting; a is n x n row-major, b becomes the solution
+static bool sc_linear_solve(double* a, double* b, int n) {
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < n; r++) {
+            if (fabs(a[r * n + col]) > fabs(a[pivot * n + col])) pivot = r;
+        }
+        if (fabs(a[pivot * n + col]) < 1e-300) return false;
+        if (pivot != col) {
+            for (int c = 0; c < n; c++) {
+                double t = a[col * n + c];
+                a[col * n + c] = a[pivot * n + c];
+                a[pivot * n + c] = t;
+            }
+            double t = b[col];
+            b[col] = b[pivot];
+            b[pivot] = t;
+        }
+        for (int r = col + 1; r < n; r++) {
+            double factor = a[r * n + col] / a[col * n + col];
+            for (int c = col; c < n; c++) a[r * n + c] -= factor * a[col * n + c];
+            b[r] -= factor * b[col];
+        }
+    }
+    for (int r = n - 1; r >= 0; r--) {
+        for (int c = r + 1; c < n; c++) b[r] -= a[r * n + c] * b[c];
+        b[r] /= a[r * n + r];
+    }
+    return true;
+}
+
+static double sc_norm(const double* f, int n) {
+    double m = 0.0;
+    for (int i = 0; i < n; i++) m = fmax(m, fabs(f[i]));
+    return m;
+}
+
+// maps the unit disk onto the upper half-plane, sending 1 to infinity
+static double complex sc_cayley(double complex u) {
+    return I * (1.0 + u) / (1.0 - u);
+}
+
+static double complex sc_evaluate_from(const SchwarzChristoffel* sc, double complex s, int anchor_limit) {
+    // start from the closest prevertex or cached anchor
+    int best_vertex = 0;
+    double best = cabs(s - sc->z[0]);
+    for (int k = 1; k < sc->n - 1; k++) {
+        double d = cabs(s - sc->z[k]);
+        if (d < best) {
+            best = d;
+            best_vertex = k;
+        }
+    }
+    int best_anchor = -1;
+    for (int a = 0; a < anchor_limit; a++) {
+        double d = cabs(s - sc->anchor_z[a]);
+        if (d < best) {
+            best = d;
+            best_anchor = a;
+        }
+    }
+    if (best_anchor >= 0) {
+        return sc->anchor_w[best_anchor] + sc->constant * sc_integrate(sc, sc->anchor_z[best_anchor], -1, s, false);
+    }
+    return sc->w[best_vertex] + sc->constant * sc_integrate(sc, sc->z[best_vertex], best_vertex, s, false);
+}
+
+// solves for the prevertices of a polygon given as n >= 3 vertices in either orientation;
+// leaves sc->solved false for degenerate input or when newton does not converge
+bool sc_solve(SchwarzChristoffel* sc, const Complex* vertices, int n, float domain_radius) {
+    sc->solved = false;
+    sc->iterations = 0;
+    if (n < 3 || n > SC_MAX_VERTICES) return false;
+    sc->n = n;
+    sc->domain_radius = domain_radius;
+    double area = 0.0;
+    for (int k = 0; k < n; k++) {
+        Complex a = vertices[k], b = vertices[(k + 1) % n];
+        area += (double)a.real * b.imag - (double)b.real * a.imag;
+    }
+    for (int k = 0; k < n; k++) {
+        Complex v = vertices[area > 0.0 ? k : n - 1 - k];
+        sc->w[k] = v.real + I * v.imag;
+    }
+    double log_sides[SC_MAX_VERTICES];
+    double turning = 0.0;
+    for (int k = 0; k < n; k++) {
+        double complex in = sc->w[k] - sc->w[(k + n - 1) % n];
+        double complex out = sc->w[(k + 1) % n] - sc->w[k];
+        if (cabs(in) < 1e-9 || cabs(out) < 1e-9) return false;
+        double turn = carg(out / in);
+        sc->beta[k] = -turn / M_PI;
+        if (fabs(sc->beta[k]) > 0.999) return false;
+        turning += turn;
+        log_sides[k] = log(cabs(out));
+    }
+    // a self-intersecting outline does not turn exactly once
+    if (fabs(turning - 2.0 * M_PI) > 1e-6) return false;
+    
+    gauss_jacobi(sc->legendre_x, sc->legendre_w, SC_NODES, 0.0, 0.0);
+    for (int k = 0; k < n - 1; k++) {
+        gauss_jacobi(sc->jacobi_x[k], sc->jacobi_w[k], SC_NODES, 0.0, sc->beta[k]);
+    }
+    
+    // first guess: prevertices spaced on the circle like the vertices along the perimeter,
+    // pulled to the line by the cayley map and normalized so that z_0 = 0 and z_1 = 1
+    double perimeter = 0.0, along[SC_MAX_VERTICES];
+    for (int k = 0; k < n; k++) {
+        along[k] = perimeter;
+        perimeter += exp(log_sides[k]);
+    }
+    double x[SC_MAX_VERTICES];
+    for (int k = 0; k < n - 1; k++) {
+        double theta = 2.0 * M_PI * (along[k] + exp(log_sides[n - 1])) / perimeter;
+        x[k] = -1.0 / tan(0.5 * theta);
+    }
+    int m = n - 3;
+    double y[SC_MAX_VERTICES], f[SC_MAX_VERTICES], step[SC_MAX_VERTICES], trial[SC_MAX_VERTICES], trial_f[SC_MAX_VERTICES];
+    double jacobian[(SC_MAX_VERTICES - 3) * (SC_MAX_VERTICES - 3)];
+    for (int j = 0; j < m; j++) {
+        y[j] = log((x[j + 2] - x[j + 1]) / (x[1] - x[0]));
+    }
+    
+    // damped newton with a finite-difference jacobian
+    sc_residual(sc, y, log_sides, f);
+    double norm = sc_norm(f, m);
+    const double delta = 1e-7;
+    while (norm > 1e-10 && sc->iterations < 50) {
+        sc->iterations++;
+        for (int j = 0; j < m; j++) {
+            double saved = y[j];
+            y[j] += delta;
+            sc_residual(sc, y, log_sides, trial_f);
+            y[j] = saved;
+            for (int i = 0; i < m; i++) jacobian[i * m + j] = (trial_f[i] - f[i]) / delta;
+        }
+        for (int i = 0; i < m; i++) step[i] = -f[i];
+        if (!sc_linear_solve(jacobian, step, m)) return false;
+        double lambda = 1.0;
+        double trial_norm = INFINITY;
+        for (int halvings = 0; halvings < 20; halvings++) {
+            for (int j = 0; j < m; j++) trial[j] = y[j] + lambda * step[j];
+            sc_residual(sc, trial, log_sides, trial_f);
+            trial_norm = sc_norm(trial_f, m);
+            if (trial_norm < norm) break;
+            lambda *= 0.5;
+        }
+        if (!(trial_norm < norm)) break;
+        for (int j = 0; j < m; j++) {
+            y[j] = trial[j];
+            f[j] = trial_f[j];
+        }
+        norm = trial_norm;
+    }
+    sc_set_prevertices(sc, y);
+    if (!(norm < 1e-8)) return false;
+    
+    sc->constant = (sc->w[1] - sc->w[0]) / sc_side_integral(sc, 0, false);
+    // anchors on a polar grid of the input disk, each integrated from the nearest known point
+    sc->anchor_z[0] = sc_cayley(0.0);
+    sc->anchor_w[0] = sc_evaluate_from(sc, sc->anchor_z[0], 0);
+    for (int r = 0; r < SC_ANCHOR_RINGS; r++) {
+        double radius = 1.0 - pow(0.5, r + 1);
+        for (int a = 0; a < SC_ANCHOR_SPOKES; a++) {
+            int index = 1 + r * SC_ANCHOR_SPOKES + a;
+            double angle = 2.0 * M_PI * (a + 0.5) / SC_ANCHOR_SPOKES;
+            sc->anchor_z[index] = sc_cayley(radius * cexp(I * angle));
+            sc->anchor_w[index] = sc_evaluate_from(sc, sc->anchor_z[index], index);
+        }
+    }
+    sc->solved = true;
+    return true;
+}
+
+// the polygon stage: |z| < domain_radius is read as the unit disk, carried to the
+// half-plane and mapped onto the polygon; points outside the disk come back as nan
+Complex sc_mapping(const SchwarzChristoffel* sc, Complex z) {
+    if (sc == NULL || !sc->solved) return z;
+    double complex u = (z.real + I * z.imag) / sc->domain_radius;
+    if (cabs(u) >= 1.0) return complex_create(NAN, NAN);
+    double complex w = sc_evaluate_from(sc, sc_cayley(u), SC_ANCHORS);
+    return complex_create((float)creal(w), (float)cimag(w));
+}
+
+// geodesic zipper map of the disk onto the inside of a closed freehand curve; the curve is
+// resampled to n points and unzipped one point per elementary map:
+//   phi_1(z) = i sqrt((z - z_1)/(z - z_0))                  (plane minus [z_0, z_1] -> half-plane)
+//   f_k(z) = sqrt_upper(T_k(z)^2 + b_k^2), T_k(z) = z/(1 - a_k z)  (half-plane minus an arc -> half-plane)
+//   final(z) = sign (z/(1 - z/p))^2, then a mobius map onto the disk sending the interior point to 0
+#define ZIPPER_MAX_POINTS 2048
+#define ZIPPER_MIN_POINTS 64
+#define ZIPPER_SPACING 0.02
+#define ZIPPER_GRID 128
+
+typedef struct {
+    int n;                     // resampled boundary points, curve[0] and curve[1] open the first slit
+    double complex* curve;
+    double* a;                 // per point k >= 2: a_k = Re c/|c|^2 and b_k^2 = (|c|^2/Im c)^2
+    double* b_squared;
+    double inverse_p;          // 1/p for the final map, 0 when p is infinite
+    double sign;
+    double complex q;          // image of the interior point in the half-plane
+    double complex interior;
+    Complex* inverse_grid;     // disk -> region samples over [-1, 1]^2, nan outside the disk
+    Complex* forward_grid;     // region -> disk samples over the bounding box, nan outside the region
+    double complex lo, hi;     // bounding box of the curve
+    float domain_radius;       // the disk |z| < domain_radius stands for the unit disk
+    bool solved;
+} ZipperMap;
+
+// square root with nonnegative imaginary part
+static inline double complex zipper_sqrt_upper(double complex u) {
+    return I * csqrt(-u);
+}
+
+// region -> disk for a batch; map-major order keeps each elementary map's parameters hot
+// while the inner loop streams over the points
+void zipper_forward_batch(const ZipperMap* zm, double complex* v, int count) {
+    double complex z0 = zm->curve[0], z1 = zm->curve[1];
+    for (int i = 0; i < count; i++) {
+        v[i] = I * csqrt((v[i] - z1) / (v[i] - z0));
+    }
+    for (int k = 2; k < zm->n; k++) {
+        double a = zm->a[k], b_squared = zm->b_squared[k];
+        for (int i = 0; i < count; i++) {
+            double complex t = v[i] / (1.0 - a * v[i]);
+            v[i] = zipper_sqrt_upper(t * t + b_squared);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        double complex t = v[i] / (1.0 - v[i] * zm->inverse_p);
+        double complex w = zm->sign * t * t;
+        v[i] = (w - zm->q) / (w - conj(zm->q));
+    }
+}
+
+// disk -> region for a batch, the elementary maps inverted in reverse order
+void zipper_inverse_batch(const ZipperMap* zm, double complex* v, int count) {
+    double complex z0 = zm->curve[0], z1 = zm->curve[1];
+    for (int i = 0; i < count; i++) {
+        double complex w = (zm->q - conj(zm->q) * v[i]) / (1.0 - v[i]);
+        double complex t = zm->sign > 0 ? csqrt(w) : I * csqrt(w);
+        v[i] = t / (1.0 + t * zm->inverse_p);
+    }
+    for (int k = zm->n - 1; k >= 2; k--) {
+        double a = zm->a[k], b_squared = zm->b_squared[k];
+        for (int i = 0; i < count; i++) {
+            double complex s = zipper_sqrt_upper(v[i] * v[i] - b_squared);
+            v[i] = s / (1.0 + a * s);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        double complex g = -v[i] * v[i];
+        v[i] = (z1 - g * z0) / (1.0 - g);
+    }
+}
+
+static bool zipper_inside(const ZipperMap* zm, double complex p) {
+    bool inside = false;
+    for (int i = 0, j = zm->n - 1; i < zm->n; j = i++) {
+        double complex a = zm->curve[i], b = zm->curve[j];
+        if ((cimag(a) > cimag(p)) != (cimag(b) > cimag(p)) &&
+            creal(p) < creal(b) + (creal(a) - creal(b)) * (cimag(p) - cimag(b)) / (cimag(a) - cimag(b))) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static bool zipper_segments_cross(double complex a, double complex b, double complex c, double complex d) {
+    double d1 = cimag(conj(b - a) * (c - a)), d2 = cimag(conj(b - a) * (d - a));
+    double d3 = cimag(conj(d - c) * (a - c)), d4 = cimag(conj(d - c) * (b - c));
+    return ((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0));
+}
+
+void zipper_free(ZipperMap* zm) {
+    free(zm->curve);
+    free(zm->a);
+    free(zm->b_squared);
+    free(zm->inverse_grid);
+    free(zm->forward_grid);
+    *zm = (ZipperMap){0};
+}
+
+// resamples the closed stroke to even arc length and computes the elementary maps;
+// the sample grids are filled separately by zipper_build_grids
+bool zipper_solve(ZipperMap* zm, const Complex* stroke, int count, float domain_radius) {
+    zipper_free(zm);
+    zm->domain_radius = domain_radius;
+    if (count < 3) return false;
+    double perimeter = 0.0;
+    for (int i = 0; i < count; i++) {
+        Complex a = stroke[i], b = stroke[(i + 1) % count];
+        perimeter += hypot(b.real - a.real, b.imag - a.imag);
+    }
+    int n = (int)(perimeter / ZIPPER_SPACING);
+    if (n < ZIPPER_MIN_POINTS) n = ZIPPER_MIN_POINTS;
+    if (n > ZIPPER_MAX_POINTS) n = ZIPPER_MAX_POINTS;
+    zm->curve = (double complex*)malloc(n * sizeof(double complex));
+    zm->a = (double*)malloc(n * sizeof(double));
+    zm->b_squared = (double*)malloc(n * sizeof(double));
+    double complex* image = (double complex*)malloc((n + 1) * sizeof(double complex));
+    if (zm->curve == NULL || zm->a == NULL || zm->b_squared == NULL || image == NULL) {
+        free(image);
+        zipper_free(zm);
+        return false;
+    }
+    zm->n = n;
+    
+    // even arc-length resampling of the closed polyline
+    int segment = 0;
+    double segment_start = 0.0;
+    for (int i = 0; i < n; i++) {
+        double target = perimeter * i / n;
+        for (;;) {
+            Complex a = stroke[segment], b = stroke[(segment + 1) % count];
+            double length = hypot(b.real - a.real, b.imag - a.imag);
+            if (target <= segment_start + length || segment == count - 1) {
+                double f = length > 0.0 ? (target - segment_start) / length : 0.0;
+                zm->curve[i] = (a.real + f * (b.real - a.real)) + I * (a.imag + f * (b.imag - a.imag));
+                break;
+            }
+            segment_start += length;
+            segment++;
+        }
+    }
+    
+    bool simple = true;
+    for (int i = 0; i < n && simple; i++) {
+        for (int j = i + 2; j < n; j++) {
+            if (i == 0 && j == n - 1) continue;
+            if (zipper_segments_cross(zm->curve[i], zm->curve[(i + 1) % n], zm->curve[j], zm->curve[(j + 1) % n])) {
+                simple = false;
+                break;
+            }
+        }
+    }
+    
+    // the interior point is the inside sample farthest from the curve, on a coarse grid
+    zm->lo = zm->hi = zm->curve[0];
+    for (int i = 1; i < n; i++) {
+        zm->lo = fmin(creal(zm->lo), creal(zm->curve[i])) + I * fmin(cimag(zm->lo), cimag(zm->curve[i]));
+        zm->hi = fmax(creal(zm->hi), creal(zm->curve[i])) + I * fmax(cimag(zm->hi), cimag(zm->curve[i]));
+    }
+    double best = 0.0;
+    for (int gy = 1; gy < 32 && simple; gy++) {
+        for (int gx = 1; gx < 32; gx++) {
+            double complex p = creal(zm->lo) + (creal(zm->hi) - creal(zm->lo)) * gx / 32.0 +
+                               I * (cimag(zm->lo) + (cimag(zm->hi) - cimag(zm->lo)) * gy / 32.0);
+            if (!zipper_inside(zm, p)) continue;
+            double nearest = INFINITY;
+            for (int i = 0; i < n; i++) nearest = fmin(nearest, cabs(p - zm->curve[i]));
+            if (nearest > best) {
+                best = nearest;
+                zm->interior = p;
+            }
+        }
+    }
+    if (!simple || best == 0.0) {
+        free(image);
+        zipper_free(zm);
+        return false;
+    }
+    
+    // unzip: image[k] follows curve point k, image[n] follows the interior point
+    double complex z0 = zm->curve[0], z1 = zm->curve[1];
+    for (int i = 2; i <= n; i++) {
+        double complex z = i < n ? zm->curve[i] : zm->interior;
+        image[i] = I * csqrt((z - z1) / (z - z0));
+    }
+    zm->inverse_p = 0.0;  // z_0 starts at infinity
+    for (int k = 2; k < n; k++) {
+        double complex c = image[k];
+        double modulus_squared = creal(c) * creal(c) + cimag(c) * cimag(c);
+        double im = fmax(cimag(c), 1e-12 * sqrt(modulus_squared));
+        double a = creal(c) / modulus_squared;
+        double b = modulus_squared / im;
+        zm->a[k] = a;
+        zm->b_squared[k] = b * b;
+        for (int i = k + 1; i <= n; i++) {
+            double complex t = image[i] / (1.0 - a * image[i]);
+            image[i] = zipper_sqrt_upper(t * t + b * b);
+        }
+        // the image of z_0 stays on the real line, on the side that T puts it
+        if (zm->inverse_p != a) {
+            double t = 1.0 / (zm->inverse_p - a);
+            zm->inverse_p = 1.0 / copysign(sqrt(t * t + b * b), t);
+        }
+    }
+    // the sign sends the side holding the interior point to the upper half-plane
+    double complex t = image[n] / (1.0 - image[n] * zm->inverse_p);
+    zm->sign = cimag(t * t) >= 0.0 ? 1.0 : -1.0;
+    zm->q = zm->sign * t * t;
+    free(image);
+    zm->solved = cimag(zm->q) > 0.0 && isfinite(creal(zm->q));
+    return zm->solved;
+}
+
+// bilinear lookup in a (ZIPPER_GRID + 1)^2 sample grid, or nan when a corner is missing
+static Complex zipper_grid_lookup(const Complex* grid, double gx, double gy) {
+    int x = (int)gx, y = (int)gy;
+    if (x < 0 || y < 0 || x >= ZIPPER_GRID || y >= ZIPPER_GRID) return complex_create(NAN, NAN);
+    float fx = (float)(gx - x), fy = (float)(gy - y);
+    const Complex* row0 = grid + y * (ZIPPER_GRID + 1) + x;
+    const Complex* row1 = row0 + ZIPPER_GRID + 1;
+    return complex_create((1 - fy) * ((1 - fx) * row0[0].real + fx * row0[1].real) + fy * ((1 - fx) * row1[0].real + fx * row1[1].real),
+                          (1 - fy) * ((1 - fx) * row0[0].imag + fx * row0[1].imag) + fy * ((1 - fx) * row1[0].imag + fx * row1[1].imag));
+}
+
+// the curve stage: |z| < domain_radius is read as the unit disk and mapped into the curve;
+// cells of the cached grid that touch the circle fall back to the exact composition
+Complex zipper_mapping(const ZipperMap* zm, Complex z) {
+    if (zm == NULL || !zm->solved || zm->inverse_grid == NULL) return complex_create(NAN, NAN);
+    double complex u = (z.real + I * z.imag) / zm->domain_radius;
+    if (cabs(u) >= 1.0) return complex_create(NAN, NAN);
+    Complex w = zipper_grid_lookup(zm->inverse_grid, (creal(u) + 1.0) * 0.5 * ZIPPER_GRID, (cimag(u) + 1.0) * 0.5 * ZIPPER_GRID);
+    if (isfinite(w.real) && isfinite(w.imag)) return w;
+    zipper_inverse_batch(zm, &u, 1);
+    return complex_create((float)creal(u), (float)cimag(u));
+}
+
+// the inverse curve stage: points inside the curve go to the disk of radius domain_radius
+Complex zipper_inverse_mapping(const ZipperMap* zm, Complex z) {
+    if (zm == NULL || !zm->solved || zm->forward_grid == NULL) return complex_create(NAN, NAN);
+    double complex p = z.real + I * z.imag;
+    double gx = (z.real - creal(zm->lo)) / (creal(zm->hi) - creal(zm->lo)) * ZIPPER_GRID;
+    double gy = (z.imag - cimag(zm->lo)) / (cimag(zm->hi) - cimag(zm->lo)) * ZIPPER_GRID;
+    Complex w = zipper_grid_lookup(zm->forward_grid, gx, gy);
+    if (isfinite(w.real) && isfinite(w.imag)) return w;
+    if (gx < 0 || gy < 0 || gx > ZIPPER_GRID || gy > ZIPPER_GRID || !zipper_inside(zm, p)) return complex_create(NAN, NAN);
+    zipper_forward_batch(zm, &p, 1);
+    return complex_create((float)(creal(p) * zm->domain_radius), (float)(cimag(p) * zm->domain_radius));
+}
+
+typedef enum {
+    MAP_IDENTITY,
+    MAP_SQUARE,
+    MAP_RECIPROCAL,
+    MAP_EXP,
+    MAP_MOBIUS,
+    MAP_POLYGON,
+    MAP_CURVE,
+    MAP_CURVE_INVERSE,
+    MAP_KIND_COUNT
+} MappingKind;
+
+const char* mapping_kind_names[MAP_KIND_COUNT] = {
+    "z",
+    "z^2",
+    "1/z",
+    "e^z",
+    "möbius",
+    "polygon",
+    "curve",
+    "curve^-1"
+};
+
+typedef struct {
+    MappingKind kind;
+    MobiusCoefficients mobius;  // used by MAP_MOBIUS stages
+    const SchwarzChristoffel* polygon;  // used by MAP_POLYGON stages
+    const ZipperMap* zipper;            // used by MAP_CURVE and MAP_CURVE_INVERSE stages
+} MappingStage;
+
+#define MAX_CHAIN_STAGES 8
+
+// stages apply in order, so stages[0] acts on z first
+typedef struct {
+    MappingStage stages[MAX_CHAIN_STAGES];
+    int stage_count;
+} MappingChain;
+
+typedef enum {
+    OP_MOBIUS,
+    OP_SQUARE,
+    OP_EXP,
+    OP_POLYGON,
+    OP_CURVE,
+    OP_CURVE_INVERSE
+} KernelOpCode;
+
+typedef struct {
+    KernelOpCode code;
+    MobiusCoefficients m;
+    const SchwarzChristoffel* polygon;
+    const ZipperMap* zipper;
+} KernelOp;
+
+// a chain compiled for evaluation: identity stages vanish and every run of reciprocal and
+// möbius stages collapses into a single matrix product
+typedef struct {
+    KernelOp ops[MAX_CHAIN_STAGES];
+    int op_count;
+} ChainKernel;
+
+// matrix product, i.e. the map z -> outer(inner(z))
+static MobiusCoefficients mobius_compose(MobiusCoefficients outer, MobiusCoefficients inner) {
+    MobiusCoefficients m;
+    m.a = complex_add(complex_multiply(outer.a, inner.a), complex_multiply(outer.b, inner.c));
+    m.b = complex_add(complex_multiply(outer.a, inner.b), complex_multiply(outer.b, inner.d));
+    m.c = complex_add(complex_multiply(outer.c, inner.a), complex_multiply(outer.d, inner.c));
+    m.d = complex_add(complex_multiply(outer.c, inner.b), complex_multiply(outer.d, inner.d));
+    return m;
+}
+
+// compiles the first stage_count stages of the chain
+void chain_compile(const MappingChain* chain, int stage_count, ChainKernel* kernel) {
+    static const MobiusCoefficients reciprocal = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 0.0f}};
+    kernel->op_count = 0;
+    for (int s = 0; s < stage_count; s++) {
+        const MappingStage* stage = &chain->stages[s];
+        if (stage->kind == MAP_SQUARE || stage->kind == MAP_EXP) {
+            kernel->ops[kernel->op_count++] = (KernelOp){stage->kind == MAP_SQUARE ? OP_SQUARE : OP_EXP, mobius_default, NULL, NULL};
+        } else if (stage->kind == MAP_POLYGON) {
+            kernel->ops[kernel->op_count++] = (KernelOp){OP_POLYGON, mobius_default, stage->polygon, NULL};
+        } else if (stage->kind == MAP_CURVE || stage->kind == MAP_CURVE_INVERSE) {
+            kernel->ops[kernel->op_count++] = (KernelOp){stage->kind == MAP_CURVE ? OP_CURVE : OP_CURVE_INVERSE, mobius_default, NULL, stage->zipper};
+        } else if (stage->kind == MAP_RECIPROCAL || stage->kind == MAP_MOBIUS) {
+            MobiusCoefficients m = stage->kind == MAP_RECIPROCAL ? reciprocal : stage->mobius;
+            KernelOp* last = kernel->op_count > 0 ? &kernel->ops[kernel->op_count - 1] : NULL;
+            if (last != NULL && last->code == OP_MOBIUS) {
+                last->m = mobius_compose(m, last->m);
+            } else {
+                kernel->ops[kernel->op_count++] = (KernelOp){OP_MOBIUS, m, NULL, NULL};
+            }
+        }
+    }
+}
+
+// prefixes[k] evaluates the first k stages; prefixes[stage_count] is the whole chain
+void chain_compile_prefixes(const MappingChain* chain, ChainKernel* prefixes) {
+    for (int k = 0; k <= chain->stage_count; k++) {
+        chain_compile(chain, k, &prefixes[k]);
+    }
+}
+
+Complex chain_kernel_eval(const ChainKernel* kernel, Complex z) {
+    for (int i = 0; i < kernel->op_count; i++) {
+        const KernelOp* op = &kernel->ops[i];
+        switch (op->code) {
+            case OP_MOBIUS:
+                z = mobius_apply(op->m, z);
+                break;
+            case OP_SQUARE:
+                z = square_mapping(z);
+                break;
+            case OP_EXP:
+                z = exp_mapping(z);
+                break;
+            case OP_POLYGON:
+                z = sc_mapping(op->polygon, z);
+                break;
+            case OP_CURVE:
+                z = zipper_mapping(op->zipper, z);
+                break;
+            case OP_CURVE_INVERSE:
+                z = zipper_inverse_mapping(op->zipper, z);
+                break;
+        }
+    }
+    return z;
+}
+
+// fused batch evaluation: each point runs through the whole chain, so no per-stage arrays exist
+void chain_kernel_apply(const ChainKernel* kernel, const Complex* z, Complex* w, int n) {
+    for (int i = 0; i < n; i++) {
+        w[i] = chain_kernel_eval(kernel, z[i]);
+    }
+}
+
+const char* chain_describe(const MappingChain* chain, int selected) {
+    static char text[256];
+    int len = snprintf(text, sizeof(text), "z");
+    for (int s = 0; s < chain->stage_count && len < (int)sizeof(text); s++) {
+        const char* format = s == selected ? " -> [%s]" : " -> %s";
+        len += snprintf(text + len, sizeof(text) - len, format, mapping_kind_names[chain->stages[s].kind]);
+    }
+    return text;
+}
+
 Vector2 complex_to_screen(Complex z, Vector2 center, float scale) {
     Vector2 screen;
     screen.x = center.x + z.real * scale;
@@ -106,274 +871,1038 @@ Complex screen_to_complex(Vector2 screen, Vector2 center, float scale) {
     return z;
 }
 
-void draw_complex_circle(Complex center, float radius, Color color, Vector2 screen_center, float scale) {
-    Vector2 screen_pos = complex_to_screen(center, screen_center, scale);
-    DrawCircle(screen_pos.x, screen_pos.y, radius * scale, color);
+void draw_complex_circle(Complex center, float radius, Color color, Vector2 screen_center, float scale) {
+    Vector2 screen_pos = complex_to_screen(center, screen_center, scale);
+    DrawCircle(screen_pos.x, screen_pos.y, radius * scale, color);
+}
+
+typedef enum {
+    GRID_PATTERN,
+    CONCENTRIC_CIRCLES,
+    RADIAL_LINES,
+    POLAR_GRID
+} InputGraphType;
+
+typedef struct {
+    Complex z;
+    Complex w;
+    int connections[8];
+    int num_connections;
+} MappedPoint;
+
+typedef void (*PoolTask)(void* ctx, int index);
+
+// persistent worker pool; thread_pool_run hands out task indices and blocks until all are done,
+// with the calling thread working alongside the pool
+typedef struct {
+    pthread_t* threads;
+    int thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    PoolTask task;
+    void* ctx;
+    int task_count;
+    int next_task;
+    int active;
+    unsigned batch;
+    bool shutdown;
+} ThreadPool;
+
+static void pool_drain(ThreadPool* pool) {
+    // called with the lock held; returns with it held
+    while (pool->next_task < pool->task_count) {
+        int index = pool->next_task++;
+        pthread_mutex_unlock(&pool->lock);
+        pool->task(pool->ctx, index);
+        pthread_mutex_lock(&pool->lock);
+    }
+}
+
+static void* pool_worker(void* arg) {
+    ThreadPool* pool = (ThreadPool*)arg;
+    unsigned seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->batch == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        seen = pool->batch;
+        pool->active++;
+        pool_drain(pool);
+        if (--pool->active == 0) {
+            pthread_cond_broadcast(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+void thread_pool_init(ThreadPool* pool, int thread_count) {
+    *pool = (ThreadPool){0};
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    if (thread_count <= 0) return;
+    pool->threads = (pthread_t*)malloc(thread_count * sizeof(pthread_t));
+    if (pool->threads == NULL) return;
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&pool->threads[pool->thread_count], NULL, pool_worker, pool) != 0) break;
+        pool->thread_count++;
+    }
+}
+
+void thread_pool_run(ThreadPool* pool, int task_count, PoolTask task, void* ctx) {
+    if (pool->thread_count == 0 || task_count <= 1) {
+        for (int i = 0; i < task_count; i++) {
+            task(ctx, i);
+        }
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->task_count = task_count;
+    pool->next_task = 0;
+    pool->batch++;
+    pthread_cond_broadcast(&pool->wake);
+    pool_drain(pool);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->done);
+    *pool = (ThreadPool){0};
+}
+
+bool reserve_points(MappedPoint** points, int* capacity, int needed) {
+    if (needed <= *capacity) return true;
+    MappedPoint* grown = (MappedPoint*)realloc(*points, (size_t)needed * sizeof(MappedPoint));
+    if (grown == NULL) return false;
+    *points = grown;
+    *capacity = needed;
+    return true;
+}
+
+typedef struct {
+    ZipperMap* map;
+    bool forward;
+} ZipperGridJob;
+
+// fills one row of either sample grid through the exact batch evaluators
+static void zipper_grid_row_task(void* ctx, int row) {
+    ZipperGridJob* job = (ZipperGridJob*)ctx;
+    ZipperMap* zm = job->map;
+    double complex values[ZIPPER_GRID + 1];
+    int columns[ZIPPER_GRID + 1];
+    int count = 0;
+    Complex* out = (job->forward ? zm->forward_grid : zm->inverse_grid) + row * (ZIPPER_GRID + 1);
+    for (int col = 0; col <= ZIPPER_GRID; col++) {
+        out[col] = complex_create(NAN, NAN);
+        double complex p;
+        if (job->forward) {
+            p = creal(zm->lo) + (creal(zm->hi) - creal(zm->lo)) * col / ZIPPER_GRID +
+                I * (cimag(zm->lo) + (cimag(zm->hi) - cimag(zm->lo)) * row / ZIPPER_GRID);
+            if (!zipper_inside(zm, p)) continue;
+        } else {
+            p = (2.0 * col / ZIPPER_GRID - 1.0) + I * (2.0 * row / ZIPPER_GRID - 1.0);
+            if (cabs(p) >= 1.0) continue;
+        }
+        values[count] = p;
+        columns[count++] = col;
+    }
+    if (job->forward) {
+        zipper_forward_batch(zm, values, count);
+    } else {
+        zipper_inverse_batch(zm, values, count);
+    }
+    float scale = job->forward ? zm->domain_radius : 1.0f;
+    for (int i = 0; i < count; i++) {
+        out[columns[i]] = complex_create((float)creal(values[i]) * scale, (float)cimag(values[i]) * scale);
+    }
+}
+
+// caches both directions on grids so the stages cost a bilinear lookup per point
+bool zipper_build_grids(ZipperMap* zm, ThreadPool* pool) {
+    if (!zm->solved) return false;
+    size_t cells = (size_t)(ZIPPER_GRID + 1) * (ZIPPER_GRID + 1);
+    zm->inverse_grid = (Complex*)malloc(cells * sizeof(Complex));
+    zm->forward_grid = (Complex*)malloc(cells * sizeof(Complex));
+    if (zm->inverse_grid == NULL || zm->forward_grid == NULL) {
+        free(zm->inverse_grid);
+        free(zm->forward_grid);
+        zm->inverse_grid = zm->forward_grid = NULL;
+        return false;
+    }
+    ZipperGridJob inverse_job = {zm, false};
+    ZipperGridJob forward_job = {zm, true};
+    thread_pool_run(pool, ZIPPER_GRID + 1, zipper_grid_row_task, &inverse_job);
+    thread_pool_run(pool, ZIPPER_GRID + 1, zipper_grid_row_task, &forward_job);
+    return true;
+}
+
+// graphs are generated in two parallel passes over fixed slots: every ring, line or grid row owns
+// a contiguous slot range, so a point's position never depends on scheduling. slot_index maps
+// each slot to its compacted point index (-1 when the mapped point was culled) and the second
+// pass derives every point's connections from that slot topology
+typedef struct {
+    ThreadPool* pool;
+    int* slot_index;
+    int slot_capacity;
+} GraphGenerator;
+
+typedef struct {
+    MappedPoint* points;
+    int* slot_index;
+    const ChainKernel* kernel;
+    int chunk_size;    // slots per ring, line or row
+    int chunk_count;
+    int first_slot;    // 1 when slot 0 holds the centre point
+    float step;        // grid spacing or ring radius step
+    float max_radius;
+    int grid_size;
+} GraphJob;
+
+static bool graph_reserve_slots(GraphGenerator* gen, int slots) {
+    if (slots <= gen->slot_capacity) return true;
+    int* grown = (int*)realloc(gen->slot_index, (size_t)slots * sizeof(int));
+    if (grown == NULL) return false;
+    gen->slot_index = grown;
+    gen->slot_capacity = slots;
+    return true;
+}
+
+#define GRAPH_BLOCK 256
+
+// maps a run of consecutive slots through the chain kernel and flags which ones to keep
+static void graph_store_run(GraphJob* job, int first_slot, const Complex* z, int n) {
+    Complex w[GRAPH_BLOCK];
+    chain_kernel_apply(job->kernel, z, w, n);
+    for (int i = 0; i < n; i++) {
+        int slot = first_slot + i;
+        // check if mapped point is finite and within reasonable bounds
+        if (isfinite(w[i].real) && isfinite(w[i].imag) && complex_abs(w[i]) < 100.0f) {
+            job->points[slot].z = z[i];
+            job->points[slot].w = w[i];
+            job->points[slot].num_connections = 0;
+            job->slot_index[slot] = 1;
+        } else {
+            job->slot_index[slot] = 0;
+        }
+    }
+}
+
+// turns the per-slot keep flags into point indices and moves the kept points down in slot order
+static int graph_compact(MappedPoint* points, int* slot_index, int slots) {
+    int count = 0;
+    for (int s = 0; s < slots; s++) {
+        if (slot_index[s]) {
+            if (count != s) points[count] = points[s];
+            slot_index[s] = count++;
+        } else {
+            slot_index[s] = -1;
+        }
+    }
+    return count;
+}
+
+static void link_point(MappedPoint* point, int self, int other) {
+    if (other < 0 || other == self) return;
+    for (int i = 0; i < point->num_connections; i++) {
+        if (point->connections[i] == other) return;
+    }
+    if (point->num_connections < 8) {
+        point->connections[point->num_connections++] = other;
+    }
+}
+
+// next or previous kept slot around a closed ring, skipping culled slots
+static int ring_neighbor(const GraphJob* job, int ring_start, int p, int direction) {
+    for (int k = 1; k < job->chunk_size; k++) {
+        int q = (p + direction * k + job->chunk_size * k) % job->chunk_size;
+        int idx = job->slot_index[ring_start + q];
+        if (idx >= 0) return idx;
+    }
+    return -1;
+}
+
+static void link_center(const GraphJob* job, int first_ring_start) {
+    // the centre keeps its first eight spokes; every first-ring point still links back to it
+    int center = job->slot_index[0];
+    if (center < 0) return;
+    for (int p = 0; p < job->chunk_size && job->points[center].num_connections < 8; p++) {
+        link_point(&job->points[center], center, job->slot_index[first_ring_start + p]);
+    }
+}
+
+static void grid_points_task(void* ctx, int row) {
+    GraphJob* job = (GraphJob*)ctx;
+    Complex z[GRAPH_BLOCK];
+    int i = row - job->grid_size;
+    for (int col0 = 0; col0 < job->chunk_size; col0 += GRAPH_BLOCK) {
+        int n = job->chunk_size - col0 < GRAPH_BLOCK ? job->chunk_size - col0 : GRAPH_BLOCK;
+        for (int k = 0; k < n; k++) {
+            z[k] = complex_create(i * job->step, (col0 + k - job->grid_size) * job->step);
+        }
+        graph_store_run(job, row * job->chunk_size + col0, z, n);
+    }
+}
+
+static void grid_links_task(void* ctx, int row) {
+    GraphJob* job = (GraphJob*)ctx;
+    int n = job->chunk_size;
+    for (int col = 0; col < n; col++) {
+        int idx = job->slot_index[row * n + col];
+        if (idx < 0) continue;
+        MappedPoint* point = &job->points[idx];
+        // right, up, left, down
+        if (row + 1 < n) link_point(point, idx, job->slot_index[(row + 1) * n + col]);
+        if (col + 1 < n) link_point(point, idx, job->slot_index[row * n + col + 1]);
+        if (row > 0) link_point(point, idx, job->slot_index[(row - 1) * n + col]);
+        if (col > 0) link_point(point, idx, job->slot_index[row * n + col - 1]);
+    }
+}
+
+static void ring_points_task(void* ctx, int ring) {
+    GraphJob* job = (GraphJob*)ctx;
+    Complex z[GRAPH_BLOCK];
+    float radius = (ring + 1) * job->step;
+    int start = job->first_slot + ring * job->chunk_size;
+    for (int p0 = 0; p0 < job->chunk_size; p0 += GRAPH_BLOCK) {
+        int n = job->chunk_size - p0 < GRAPH_BLOCK ? job->chunk_size - p0 : GRAPH_BLOCK;
+        for (int k = 0; k < n; k++) {
+            float angle = (p0 + k) * (2.0f * PI / job->chunk_size);
+            z[k] = complex_create(radius * cosf(angle), radius * sinf(angle));
+        }
+        graph_store_run(job, start + p0, z, n);
+    }
+}
+
+// concentric circles: ring neighbours plus a spoke on every fourth angle
+static void circle_links_task(void* ctx, int ring) {
+    GraphJob* job = (GraphJob*)ctx;
+    int n = job->chunk_size;
+    int start = job->first_slot + ring * n;
+    for (int p = 0; p < n; p++) {
+        int idx = job->slot_index[start + p];
+        if (idx < 0) continue;
+        MappedPoint* point = &job->points[idx];
+        link_point(point, idx, ring_neighbor(job, start, p, 1));
+        link_point(point, idx, ring_neighbor(job, start, p, -1));
+        if (ring == 0) {
+            link_point(point, idx, job->slot_index[0]);
+        } else if (p % 4 == 0) {
+            link_point(point, idx, job->slot_index[start - n + p]);
+        }
+        if (ring + 1 < job->chunk_count && p % 4 == 0) {
+            link_point(point, idx, job->slot_index[start + n + p]);
+        }
+    }
+}
+
+// polar grid: ring neighbours plus a spoke on every angle
+static void polar_links_task(void* ctx, int ring) {
+    GraphJob* job = (GraphJob*)ctx;
+    int n = job->chunk_size;
+    int start = job->first_slot + ring * n;
+    for (int p = 0; p < n; p++) {
+        int idx = job->slot_index[start + p];
+        if (idx < 0) continue;
+        MappedPoint* point = &job->points[idx];
+        link_point(point, idx, ring_neighbor(job, start, p, 1));
+        link_point(point, idx, ring_neighbor(job, start, p, -1));
+        link_point(point, idx, ring == 0 ? job->slot_index[0] : job->slot_index[start - n + p]);
+        if (ring + 1 < job->chunk_count) {
+            link_point(point, idx, job->slot_index[start + n + p]);
+        }
+    }
+}
+
+static void radial_points_task(void* ctx, int line) {
+    GraphJob* job = (GraphJob*)ctx;
+    float angle = line * (2.0f * PI / job->chunk_count);
+    float dx = cosf(angle);
+    float dy = sinf(angle);
+    Complex z[GRAPH_BLOCK];
+    int start = job->first_slot + line * job->chunk_size;
+    for (int p0 = 0; p0 < job->chunk_size; p0 += GRAPH_BLOCK) {
+        int n = job->chunk_size - p0 < GRAPH_BLOCK ? job->chunk_size - p0 : GRAPH_BLOCK;
+        for (int k = 0; k < n; k++) {
+            float radius = (p0 + k + 1) * (job->max_radius / job->chunk_size);
+            z[k] = complex_create(radius * dx, radius * dy);
+        }
+        graph_store_run(job, start + p0, z, n);
+    }
+}
+
+// radial lines: neighbours along the line and the same radius on both adjacent lines
+static void radial_links_task(void* ctx, int line) {
+    GraphJob* job = (GraphJob*)ctx;
+    int n = job->chunk_size;
+    int start = job->first_slot + line * n;
+    int next = job->first_slot + ((line + 1) % job->chunk_count) * n;
+    int prev = job->first_slot + ((line + job->chunk_count - 1) % job->chunk_count) * n;
+    for (int p = 0; p < n; p++) {
+        int idx = job->slot_index[start + p];
+        if (idx < 0) continue;
+        MappedPoint* point = &job->points[idx];
+        link_point(point, idx, p > 0 ? job->slot_index[start + p - 1] : job->slot_index[0]);
+        if (p + 1 < n) link_point(point, idx, job->slot_index[start + p + 1]);
+        link_point(point, idx, job->slot_index[next + p]);
+        link_point(point, idx, job->slot_index[prev + p]);
+    }
+}
+
+static void graph_store_center(GraphJob* job) {
+    Complex origin = complex_create(0.0f, 0.0f);
+    graph_store_run(job, 0, &origin, 1);
+}
+
+// points must hold at least (2 * size + 1)^2 entries
+void generate_grid_points(GraphGenerator* gen, MappedPoint* points, int* count, float spacing, int size, const ChainKernel* kernel) {
+    int n = 2 * size + 1;
+    *count = 0;
+    if (!graph_reserve_slots(gen, n * n)) return;
+    GraphJob job = {points, gen->slot_index, kernel, n, n, 0, spacing, 0.0f, size};
+    thread_pool_run(gen->pool, n, grid_points_task, &job);
+    *count = graph_compact(points, gen->slot_index, n * n);
+    thread_pool_run(gen->pool, n, grid_links_task, &job);
+}
+
+// points must hold at least 1 + num_circles * points_per_circle entries
+void generate_concentric_circles(GraphGenerator* gen, MappedPoint* points, int* count, int num_circles, int points_per_circle,
+                                 float radius_step, const ChainKernel* kernel) {
+    int slots = 1 + num_circles * points_per_circle;
+    *count = 0;
+    if (!graph_reserve_slots(gen, slots)) return;
+    GraphJob job = {points, gen->slot_index, kernel, points_per_circle, num_circles, 1, radius_step, 0.0f, 0};
+    graph_store_center(&job);
+    thread_pool_run(gen->pool, num_circles, ring_points_task, &job);
+    *count = graph_compact(points, gen->slot_index, slots);
+    thread_pool_run(gen->pool, num_circles, circle_links_task, &job);
+    link_center(&job, 1);
+}
+
+// points must hold at least 1 + num_lines * points_per_line entries
+void generate_radial_lines(GraphGenerator* gen, MappedPoint* points, int* count, int num_lines, int points_per_line, float max_radius,
+                           const ChainKernel* kernel) {
+    int slots = 1 + num_lines * points_per_line;
+    *count = 0;
+    if (!graph_reserve_slots(gen, slots)) return;
+    GraphJob job = {points, gen->slot_index, kernel, points_per_line, num_lines, 1, 0.0f, max_radius, 0};
+    graph_store_center(&job);
+    thread_pool_run(gen->pool, num_lines, radial_points_task, &job);
+    *count = graph_compact(points, gen->slot_index, slots);
+    thread_pool_run(gen->pool, num_lines, radial_links_task, &job);
+    // the centre gathers the first point of the first lines, up to its eight connections
+    int center = gen->slot_index[0];
+    for (int l = 0; center >= 0 && l < num_lines && points[center].num_connections < 8; l++) {
+        link_point(&points[center], center, gen->slot_index[1 + l * points_per_line]);
+    }
+}
+
+// points must hold at least 1 + num_circles * num_lines entries
+void generate_polar_grid(GraphGenerator* gen, MappedPoint* points, int* count, int num_circles, int num_lines, float radius_step,
+                         const ChainKernel* kernel) {
+    int slots = 1 + num_circles * num_lines;
+    *count = 0;
+    if (!graph_reserve_slots(gen, slots)) return;
+    GraphJob job = {points, gen->slot_index, kernel, num_lines, num_circles, 1, radius_step, 0.0f, 0};
+    graph_store_center(&job);
+    thread_pool_run(gen->pool, num_circles, ring_points_task, &job);
+    *count = graph_compact(points, gen->slot_index, slots);
+    thread_pool_run(gen->pool, num_circles, polar_links_task, &job);
+    link_center(&job, 1);
+}
+
+// implicit k-d tree over the mapped positions w; node of range [lo, hi) is order[(lo + hi) / 2],
+// split on real part at even depth and imaginary part at odd depth
+typedef struct {
+    int* order;
+    int count;
+    int capacity;
+} KdTree;
+
+static inline float kd_key(const MappedPoint* points, int idx, int axis) {
+    return axis == 0 ? points[idx].w.real : points[idx].w.imag;
+}
+
+static void kd_select(int* order, const MappedPoint* points, int lo, int hi, int k, int axis) {
+    // quickselect so that order[k] holds the median and the ranges on either side are partitioned
+    hi--;
+    while (lo < hi) {
+        float pivot = kd_key(points, order[(lo + hi) / 2], axis);
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (kd_key(points, order[i], axis) < pivot) i++;
+            while (kd_key(points, order[j], axis) > pivot) j--;
+            if (i <= j) {
+                int tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else return;
+    }
+}
+
+static void kd_build_range(int* order, const MappedPoint* points, int lo, int hi, int depth) {
+    if (hi - lo <= 1) return;
+    int mid = (lo + hi) / 2;
+    kd_select(order, points, lo, hi, mid, depth & 1);
+    kd_build_range(order, points, lo, mid, depth + 1);
+    kd_build_range(order, points, mid + 1, hi, depth + 1);
+}
+
+void kdtree_build(KdTree* tree, const MappedPoint* points, int count) {
+    if (count > tree->capacity) {
+        int* order = (int*)realloc(tree->order, count * sizeof(int));
+        if (order == NULL) {
+            tree->count = 0;
+            return;
+        }
+        tree->order = order;
+        tree->capacity = count;
+    }
+    for (int i = 0; i < count; i++) {
+        tree->order[i] = i;
+    }
+    tree->count = count;
+    kd_build_range(tree->order, points, 0, count, 0);
+}
+
+void kdtree_free(KdTree* tree) {
+    free(tree->order);
+    tree->order = NULL;
+    tree->count = 0;
+    tree->capacity = 0;
+}
+
+static void kd_nearest_range(const KdTree* tree, const MappedPoint* points, int lo, int hi, int depth,
+                             Complex target, int* best, float* best_dist_sq) {
+    if (lo >= hi) return;
+    int mid = (lo + hi) / 2;
+    int idx = tree->order[mid];
+    float dx = points[idx].w.real - target.real;
+    float dy = points[idx].w.imag - target.imag;
+    float dist_sq = dx * dx + dy * dy;
+    if (dist_sq < *best_dist_sq) {
+        *best_dist_sq = dist_sq;
+        *best = idx;
+    }
+
+    float diff = (depth & 1) ? dy : dx;
+    // descend into the side containing the target first, then the far side only if the plane is close enough
+    if (diff > 0) {
+        kd_nearest_range(tree, points, lo, mid, depth + 1, target, best, best_dist_sq);
+        if (diff * diff < *best_dist_sq) {
+            kd_nearest_range(tree, points, mid + 1, hi, depth + 1, target, best, best_dist_sq);
+        }
+    } else {
+        kd_nearest_range(tree, points, mid + 1, hi, depth + 1, target, best, best_dist_sq);
+        if (diff * diff < *best_dist_sq) {
+            kd_nearest_range(tree, points, lo, mid, depth + 1, target, best, best_dist_sq);
+        }
+    }
+}
+
+// index of the point whose image w is closest to target within max_dist, or -1
+int kdtree_nearest(const KdTree* tree, const MappedPoint* points, Complex target, float max_dist) {
+    int best = -1;
+    float best_dist_sq = max_dist * max_dist;
+    kd_nearest_range(tree, points, 0, tree->count, 0, target, &best, &best_dist_sq);
+    return best;
+}
+
+static void kd_radius_range(const KdTree* tree, const MappedPoint* points, int lo, int hi, int depth,
+                            Complex target, float radius_sq, int* out, int max_out, int* found) {
+    if (lo >= hi) return;
+    int mid = (lo + hi) / 2;
+    int idx = tree->order[mid];
+    float dx = points[idx].w.real - target.real;
+    float dy = points[idx].w.imag - target.imag;
+    if (dx * dx + dy * dy <= radius_sq) {
+        if (*found < max_out) out[*found] = idx;
+        (*found)++;
+    }
+
+    float diff = (depth & 1) ? dy : dx;
+    if (diff > 0 || diff * diff <= radius_sq) {
+        kd_radius_range(tree, points, lo, mid, depth + 1, target, radius_sq, out, max_out, found);
+    }
+    if (diff <= 0 || diff * diff <= radius_sq) {
+        kd_radius_range(tree, points, mid + 1, hi, depth + 1, target, radius_sq, out, max_out, found);
+    }
+}
+
+// collects up to max_out indices of points whose image lies within radius of target; returns the total match count
+int kdtree_radius(const KdTree* tree, const MappedPoint* points, Complex target, float radius, int* out, int max_out) {
+    int found = 0;
+    kd_radius_range(tree, points, 0, tree->count, 0, target, radius * radius, out, max_out, &found);
+    return found;
 }
 
-typedef enum {
-    GRID_PATTERN,
-    CONCENTRIC_CIRCLES,
-    RADIAL_LINES,
-    POLAR_GRID
-} InputGraphType;
+// adaptive quadtree over an image square in the z-plane; cells live on a dyadic lattice of
+// WARP_LATTICE steps per side so vertices shared between cells are evaluated once
+#define WARP_MAX_DEPTH 9
+#define WARP_MIN_DEPTH 3
+#define WARP_LATTICE (1 << WARP_MAX_DEPTH)
 
 typedef struct {
     Complex z;
     Complex w;
-    int connections[8];
-    int num_connections;
-} MappedPoint;
+    Vector2 uv;
+    bool valid;
+} WarpVertex;
 
-int find_point_index(MappedPoint* points, int count, Complex z, float epsilon) {
-    for (int i = 0; i < count; i++) {
-        if (complex_abs(complex_create(points[i].z.real - z.real, points[i].z.imag - z.imag)) < epsilon) {
-            return i;
-        }
+typedef struct {
+    int x;
+    int y;
+    int size;
+    int child;  // first of four children, -1 for a leaf
+} WarpCell;
+
+typedef struct {
+    WarpCell* cells;
+    int cell_count;
+    int cell_capacity;
+    int leaf_count;
+    WarpVertex* vertices;
+    int vertex_count;
+    int vertex_capacity;
+    int* lattice;  // vertex index per lattice node, -1 until evaluated
+    int* indices;
+    int index_count;
+    int index_capacity;
+    Vector2* screen;  // per-frame scratch for interpolated vertex positions
+    int screen_capacity;
+    Complex origin;
+    float extent;
+    Texture2D texture;
+} WarpMesh;
+
+static bool warp_reserve(void** data, int* capacity, int needed, size_t element_size) {
+    if (needed <= *capacity) return true;
+    int new_capacity = *capacity > 0 ? *capacity : 1024;
+    while (new_capacity < needed) new_capacity *= 2;
+    void* grown = realloc(*data, new_capacity * element_size);
+    if (grown == NULL) return false;
+    *data = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static int warp_vertex(WarpMesh* mesh, int i, int j, const ChainKernel* kernel) {
+    int slot = j * (WARP_LATTICE + 1) + i;
+    if (mesh->lattice[slot] >= 0) return mesh->lattice[slot];
+    if (!warp_reserve((void**)&mesh->vertices, &mesh->vertex_capacity, mesh->vertex_count + 1, sizeof(WarpVertex))) return -1;
+
+    float u = (float)i / WARP_LATTICE;
+    float v = (float)j / WARP_LATTICE;
+    WarpVertex* vert = &mesh->vertices[mesh->vertex_count];
+    vert->z = complex_create(mesh->origin.real + u * mesh->extent, mesh->origin.imag + v * mesh->extent);
+    vert->w = chain_kernel_eval(kernel, vert->z);
+    vert->uv = (Vector2){u, 1.0f - v};
+    vert->valid = isfinite(vert->w.real) && isfinite(vert->w.imag) && complex_abs(vert->w) < 100.0f;
+    mesh->lattice[slot] = mesh->vertex_count;
+    return mesh->vertex_count++;
+}
+
+static int warp_add_cell(WarpMesh* mesh, int x, int y, int size) {
+    if (!warp_reserve((void**)&mesh->cells, &mesh->cell_capacity, mesh->cell_count + 1, sizeof(WarpCell))) return -1;
+    mesh->cells[mesh->cell_count] = (WarpCell){x, y, size, -1};
+    return mesh->cell_count++;
+}
+
+static bool warp_split(WarpMesh* mesh, int cell) {
+    WarpCell c = mesh->cells[cell];
+    int h = c.size / 2;
+    int first = warp_add_cell(mesh, c.x, c.y, h);
+    if (first < 0 || warp_add_cell(mesh, c.x + h, c.y, h) < 0 ||
+        warp_add_cell(mesh, c.x, c.y + h, h) < 0 || warp_add_cell(mesh, c.x + h, c.y + h, h) < 0) {
+        return false;
     }
-    return -1;
+    mesh->cells[cell].child = first;
+    mesh->leaf_count += 3;
+    return true;
 }
 
-void add_connection(MappedPoint* points, int idx1, int idx2) {
-    if (idx1 < 0 || idx2 < 0) return;
-    
-    // Check if connection already exists
-    for (int i = 0; i < points[idx1].num_connections; i++) {
-        if (points[idx1].connections[i] == idx2) return;
+// leaf containing lattice point (px, py) with half-open cell bounds, or -1 outside the image
+static int warp_locate(const WarpMesh* mesh, int px, int py) {
+    if (px < 0 || py < 0 || px >= WARP_LATTICE || py >= WARP_LATTICE) return -1;
+    int cell = 0;
+    while (mesh->cells[cell].child >= 0) {
+        const WarpCell* c = &mesh->cells[cell];
+        int h = c->size / 2;
+        cell = c->child + (px >= c->x + h ? 1 : 0) + (py >= c->y + h ? 2 : 0);
     }
-    
-    // Add connection if there's space
-    if (points[idx1].num_connections < 8) {
-        points[idx1].connections[points[idx1].num_connections++] = idx2;
+    return cell;
+}
+
+// deviation in pixels of the mapped edge midpoints and centre from the cell's affine interpolation
+static float warp_cell_error(WarpMesh* mesh, int cell, const ChainKernel* kernel, float scale) {
+    WarpCell c = mesh->cells[cell];
+    int s = c.size;
+    int h = s / 2;
+    int ids[9] = {
+        warp_vertex(mesh, c.x, c.y, kernel),         warp_vertex(mesh, c.x + s, c.y, kernel),
+        warp_vertex(mesh, c.x + s, c.y + s, kernel), warp_vertex(mesh, c.x, c.y + s, kernel),
+        warp_vertex(mesh, c.x + h, c.y, kernel),     warp_vertex(mesh, c.x + s, c.y + h, kernel),
+        warp_vertex(mesh, c.x + h, c.y + s, kernel), warp_vertex(mesh, c.x, c.y + h, kernel),
+        warp_vertex(mesh, c.x + h, c.y + h, kernel)
+    };
+    int valid = 0;
+    for (int k = 0; k < 9; k++) {
+        if (ids[k] < 0) return 0.0f;
+        if (mesh->vertices[ids[k]].valid) valid++;
     }
-    
-    // Add reverse connection
-    if (points[idx2].num_connections < 8) {
-        points[idx2].connections[points[idx2].num_connections++] = idx1;
+    if (valid == 0) return 0.0f;       // nothing visible to refine
+    if (valid < 9) return INFINITY;    // straddles a pole or the clip radius
+
+    WarpVertex* v = mesh->vertices;
+    float error = 0.0f;
+    for (int k = 0; k < 4; k++) {
+        Complex a = v[ids[k]].w;
+        Complex b = v[ids[(k + 1) % 4]].w;
+        Complex m = v[ids[4 + k]].w;
+        float e = complex_abs(complex_create(m.real - 0.5f * (a.real + b.real), m.imag - 0.5f * (a.imag + b.imag)));
+        if (e > error) error = e;
     }
+    Complex mid = complex_create(0.25f * (v[ids[0]].w.real + v[ids[1]].w.real + v[ids[2]].w.real + v[ids[3]].w.real),
+                                 0.25f * (v[ids[0]].w.imag + v[ids[1]].w.imag + v[ids[2]].w.imag + v[ids[3]].w.imag));
+    float e = complex_abs(complex_create(v[ids[8]].w.real - mid.real, v[ids[8]].w.imag - mid.imag));
+    if (e > error) error = e;
+    return error * scale;
 }
 
-void generate_grid_points(MappedPoint* points, int* count, float spacing, int size, Complex (*mapping)(Complex)) {
-    *count = 0;
-    
-    // First, generate all points
-    for (int i = -size; i <= size; i++) {
-        for (int j = -size; j <= size; j++) {
-            Complex z = complex_create(i * spacing, j * spacing);
-            
-            // Skip origin for reciprocal mapping to avoid division by zero
-            if (mapping == reciprocal_mapping && i == 0 && j == 0) continue;
-            
-            Complex w = mapping(z);
-            
-            // Check if mapped point is within reasonable bounds
-            if (complex_abs(w) < 100.0f) {
-                points[*count].z = z;
-                points[*count].w = w;
-                points[*count].num_connections = 0;
-                (*count)++;
-            }
-        }
+static void warp_emit_triangle(WarpMesh* mesh, int a, int b, int c) {
+    if (a < 0 || b < 0 || c < 0) return;
+    if (!mesh->vertices[a].valid || !mesh->vertices[b].valid || !mesh->vertices[c].valid) return;
+    if (!warp_reserve((void**)&mesh->indices, &mesh->index_capacity, mesh->index_count + 3, sizeof(int))) return;
+    mesh->indices[mesh->index_count++] = a;
+    mesh->indices[mesh->index_count++] = b;
+    mesh->indices[mesh->index_count++] = c;
+}
+
+static bool warp_neighbor_finer(const WarpMesh* mesh, int px, int py, int size) {
+    int n = warp_locate(mesh, px, py);
+    return n >= 0 && mesh->cells[n].size < size;
+}
+
+bool warp_mesh_init(WarpMesh* mesh, Complex origin, float extent) {
+    *mesh = (WarpMesh){0};
+    mesh->origin = origin;
+    mesh->extent = extent;
+    mesh->lattice = (int*)malloc((WARP_LATTICE + 1) * (WARP_LATTICE + 1) * sizeof(int));
+    if (mesh->lattice == NULL) return false;
+    Image checker = GenImageChecked(512, 512, 32, 32, (Color){230, 230, 230, 255}, (Color){40, 90, 160, 255});
+    mesh->texture = LoadTextureFromImage(checker);
+    UnloadImage(checker);
+    SetTextureFilter(mesh->texture, TEXTURE_FILTER_BILINEAR);
+    return true;
+}
+
+void warp_mesh_set_image(WarpMesh* mesh, Image image) {
+    UnloadTexture(mesh->texture);
+    mesh->texture = LoadTextureFromImage(image);
+    SetTextureFilter(mesh->texture, TEXTURE_FILTER_BILINEAR);
+}
+
+// refines breadth-first while the mapped cell deviates from affine by more than tolerance pixels,
+// so a limited leaf budget is spent on the coarse levels first; then 2:1-balances the tree and
+// fans each leaf around its centre, picking up hanging midpoints so the mesh has no cracks
+void warp_mesh_build(WarpMesh* mesh, const ChainKernel* kernel, float scale, float tolerance, int max_leaves) {
+    mesh->cell_count = 0;
+    mesh->vertex_count = 0;
+    mesh->index_count = 0;
+    for (int i = 0; i < (WARP_LATTICE + 1) * (WARP_LATTICE + 1); i++) {
+        mesh->lattice[i] = -1;
     }
-    
-    // Then, add connections between adjacent grid points
-    const float epsilon = 0.01f;
-    for (int idx = 0; idx < *count; idx++) {
-        Complex z = points[idx].z;
-        
-        // Connect to adjacent points (right, up, left, down)
-        Complex neighbors[4] = {
-            complex_create(z.real + spacing, z.imag),
-            complex_create(z.real, z.imag + spacing),
-            complex_create(z.real - spacing, z.imag),
-            complex_create(z.real, z.imag - spacing)
-        };
-        
-        for (int n = 0; n < 4; n++) {
-            int neighbor_idx = find_point_index(points, *count, neighbors[n], epsilon);
-            if (neighbor_idx >= 0) {
-                add_connection(points, idx, neighbor_idx);
-            }
+    if (warp_add_cell(mesh, 0, 0, WARP_LATTICE) < 0) return;
+    mesh->leaf_count = 1;
+
+    for (int i = 0; i < mesh->cell_count; i++) {
+        int size = mesh->cells[i].size;
+        if (size == 1) continue;
+        bool split = size > (WARP_LATTICE >> WARP_MIN_DEPTH);
+        if (!split && mesh->leaf_count + 3 <= max_leaves) {
+            split = warp_cell_error(mesh, i, kernel, scale) > tolerance;
         }
+        if (split && !warp_split(mesh, i)) break;
     }
-}
 
-void generate_concentric_circles(MappedPoint* points, int* count, int num_circles, int points_per_circle, Complex (*mapping)(Complex)) {
-    *count = 0;
-    const float radius_step = 0.4f;
-    int center_idx = -1;
-    
-    if (mapping != reciprocal_mapping) {
-        Complex z = complex_create(0.0f, 0.0f);
-        Complex w = mapping(z);
-        if (complex_abs(w) < 100.0f) {
-            points[*count].z = z;
-            points[*count].w = w;
-            points[*count].num_connections = 0;
-            center_idx = *count;
-            (*count)++;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < mesh->cell_count; i++) {
+            WarpCell c = mesh->cells[i];
+            if (c.child >= 0) continue;
+            int h = c.size / 2;
+            int probes[4][2] = {
+                {c.x + c.size, c.y + h}, {c.x - 1, c.y + h}, {c.x + h, c.y + c.size}, {c.x + h, c.y - 1}
+            };
+            for (int k = 0; k < 4; k++) {
+                int n = warp_locate(mesh, probes[k][0], probes[k][1]);
+                if (n >= 0 && mesh->cells[n].size > 2 * c.size) {
+                    if (!warp_split(mesh, n)) return;
+                    changed = true;
+                }
+            }
         }
     }
-    
-    for (int c = 1; c <= num_circles; c++) {
-        float radius = c * radius_step;
-        int circle_start_idx = *count;
-        
-        for (int p = 0; p < points_per_circle; p++) {
-            float angle = p * (2.0f * PI / points_per_circle);
-            Complex z = complex_create(radius * cosf(angle), radius * sinf(angle));
-            Complex w = mapping(z);
-            
-            if (complex_abs(w) < 100.0f) {
-                points[*count].z = z;
-                points[*count].w = w;
-                points[*count].num_connections = 0;
-                (*count)++;
-            }
+
+    for (int i = 0; i < mesh->cell_count; i++) {
+        WarpCell c = mesh->cells[i];
+        if (c.child >= 0) continue;
+        int s = c.size;
+        int a = warp_vertex(mesh, c.x, c.y, kernel);
+        int b = warp_vertex(mesh, c.x + s, c.y, kernel);
+        int cc = warp_vertex(mesh, c.x + s, c.y + s, kernel);
+        int d = warp_vertex(mesh, c.x, c.y + s, kernel);
+        if (s == 1) {
+            warp_emit_triangle(mesh, a, b, cc);
+            warp_emit_triangle(mesh, a, cc, d);
+            continue;
         }
-        
-        int circle_end_idx = *count - 1;
-        for (int i = circle_start_idx; i <= circle_end_idx; i++) {
-            int next_idx = (i == circle_end_idx) ? circle_start_idx : i + 1;
-            add_connection(points, i, next_idx);
-            
-            if (c == 1 && center_idx >= 0) {
-                add_connection(points, i, center_idx);
-            }
-            
-            if (c > 1 && (i - circle_start_idx) % 4 == 0) {
-                for (int prev = circle_start_idx - points_per_circle; prev < circle_start_idx; prev++) {
-                    if (prev >= 0) {
-                        float angle1 = atan2f(points[i].z.imag, points[i].z.real);
-                        float angle2 = atan2f(points[prev].z.imag, points[prev].z.real);
-                        if (fabsf(angle1 - angle2) < 0.1f) {
-                            add_connection(points, i, prev);
-                            break;
-                        }
-                    }
-                }
+
+        int h = s / 2;
+        int q = s / 4;
+        int ring[8];
+        int n = 0;
+        ring[n++] = a;
+        if (warp_neighbor_finer(mesh, c.x + q, c.y - 1, s)) ring[n++] = warp_vertex(mesh, c.x + h, c.y, kernel);
+        ring[n++] = b;
+        if (warp_neighbor_finer(mesh, c.x + s, c.y + q, s)) ring[n++] = warp_vertex(mesh, c.x + s, c.y + h, kernel);
+        ring[n++] = cc;
+        if (warp_neighbor_finer(mesh, c.x + q, c.y + s, s)) ring[n++] = warp_vertex(mesh, c.x + h, c.y + s, kernel);
+        ring[n++] = d;
+        if (warp_neighbor_finer(mesh, c.x - 1, c.y + q, s)) ring[n++] = warp_vertex(mesh, c.x, c.y + h, kernel);
+
+        if (n == 4) {
+            warp_emit_triangle(mesh, a, b, cc);
+            warp_emit_triangle(mesh, a, cc, d);
+        } else {
+            int mid = warp_vertex(mesh, c.x + h, c.y + h, kernel);
+            for (int k = 0; k < n; k++) {
+                warp_emit_triangle(mesh, mid, ring[k], ring[(k + 1) % n]);
             }
         }
     }
 }
 
-void generate_radial_lines(MappedPoint* points, int* count, int num_lines, int points_per_line, float max_radius, Complex (*mapping)(Complex)) {
-    *count = 0;
-    int center_idx = -1;
-    int line_start_indices[64] = {0};
-    
-    if (mapping != reciprocal_mapping) {
-        Complex z = complex_create(0.0f, 0.0f);
-        Complex w = mapping(z);
-        if (complex_abs(w) < 100.0f) {
-            points[*count].z = z;
-            points[*count].w = w;
-            points[*count].num_connections = 0;
-            center_idx = *count;
-            (*count)++;
-        }
+// draws the whole warp as one textured triangle batch at animation time t
+void warp_mesh_draw(WarpMesh* mesh, float t, Vector2 center, float scale, bool wireframe) {
+    if (!warp_reserve((void**)&mesh->screen, &mesh->screen_capacity, mesh->vertex_count, sizeof(Vector2))) return;
+    for (int i = 0; i < mesh->vertex_count; i++) {
+        mesh->screen[i] = complex_to_screen(complex_lerp(mesh->vertices[i].z, mesh->vertices[i].w, t), center, scale);
     }
-    
-    for (int l = 0; l < num_lines; l++) {
-        float angle = l * (2.0f * PI / num_lines);
-        float dx = cosf(angle);
-        float dy = sinf(angle);
-        
-        line_start_indices[l] = *count;
-        
-        for (int p = 1; p <= points_per_line; p++) {
-            float radius = p * (max_radius / points_per_line);
-            Complex z = complex_create(radius * dx, radius * dy);
-            Complex w = mapping(z);
-            
-            if (complex_abs(w) < 100.0f) {
-                points[*count].z = z;
-                points[*count].w = w;
-                points[*count].num_connections = 0;
-                
-                if (p > 1) {
-                    add_connection(points, *count, *count - 1);
-                } else if (center_idx >= 0) {
-                    add_connection(points, *count, center_idx);
-                }
-                
-                (*count)++;
-            }
+
+    rlDisableBackfaceCulling();
+    rlSetTexture(mesh->texture.id);
+    rlBegin(RL_TRIANGLES);
+    rlColor4ub(255, 255, 255, 255);
+    for (int i = 0; i < mesh->index_count; i += 3) {
+        rlCheckRenderBatchLimit(3);
+        for (int k = 0; k < 3; k++) {
+            int v = mesh->indices[i + k];
+            rlTexCoord2f(mesh->vertices[v].uv.x, mesh->vertices[v].uv.y);
+            rlVertex2f(mesh->screen[v].x, mesh->screen[v].y);
         }
     }
-    
-    for (int l = 0; l < num_lines; l++) {
-        int next_l = (l + 1) % num_lines;
-        
-        for (int p = 0; p < points_per_line; p++) {
-            int idx1 = line_start_indices[l] + p;
-            int idx2 = line_start_indices[next_l] + p;
-            
-            if (idx1 < *count && idx2 < *count) {
-                add_connection(points, idx1, idx2);
-            }
+    rlEnd();
+    rlSetTexture(0);
+    rlEnableBackfaceCulling();
+
+    if (wireframe) {
+        for (int i = 0; i < mesh->index_count; i += 3) {
+            Vector2 p0 = mesh->screen[mesh->indices[i]];
+            Vector2 p1 = mesh->screen[mesh->indices[i + 1]];
+            Vector2 p2 = mesh->screen[mesh->indices[i + 2]];
+            DrawLineV(p0, p1, Fade(BLACK, 0.4f));
+            DrawLineV(p1, p2, Fade(BLACK, 0.4f));
+            DrawLineV(p2, p0, Fade(BLACK, 0.4f));
         }
     }
 }
 
-void generate_polar_grid(MappedPoint* points, int* count, int num_circles, int num_lines, Complex (*mapping)(Complex)) {
-    *count = 0;
-    const float radius_step = 0.4f;
-    int center_idx = -1;
-    int circle_start_indices[32] = {0};
-    
-    if (mapping != reciprocal_mapping) {
-        Complex z = complex_create(0.0f, 0.0f);
-        Complex w = mapping(z);
-        if (complex_abs(w) < 100.0f) {
-            points[*count].z = z;
-            points[*count].w = w;
-            points[*count].num_connections = 0;
-            center_idx = *count;
-            (*count)++;
+void warp_mesh_free(WarpMesh* mesh) {
+    UnloadTexture(mesh->texture);
+    free(mesh->cells);
+    free(mesh->vertices);
+    free(mesh->lattice);
+    free(mesh->indices);
+    free(mesh->screen);
+    *mesh = (WarpMesh){0};
+}
+
+// homotopy families f_t with f_0(z) = z and f_1 = the chain; positions are cached at
+// HOMOTOPY_KEYFRAMES evenly spaced t by a background thread and playback only interpolates them
+#define HOMOTOPY_KEYFRAMES 33
+
+// deforms a single stage from the identity (t = 0) to the stage's map (t = 1)
+Complex stage_homotopy(const MappingStage* stage, Complex z, float t) {
+    switch (stage->kind) {
+        case MAP_SQUARE: {
+            // z^(1+t) on the principal branch
+            float r = powf(complex_abs(z), 1.0f + t);
+            float theta = atan2f(z.imag, z.real) * (1.0f + t);
+            return complex_create(r * cosf(theta), r * sinf(theta));
+        }
+        case MAP_RECIPROCAL: {
+            // z / (t z^2 + 1 - t): the pole pair slides in along the imaginary axis from infinity to 0
+            Complex denominator = complex_multiply(complex_create(t, 0.0f), complex_multiply(z, z));
+            denominator.real += 1.0f - t;
+            return complex_divide(z, denominator);
+        }
+        case MAP_EXP: {
+            // (e^(tz) - 1)/t + t, which tends to z as t -> 0
+            if (t < 1e-4f) return z;
+            Complex e = exp_mapping(complex_create(t * z.real, t * z.imag));
+            return complex_create((e.real - 1.0f) / t + t, e.imag / t);
         }
+        case MAP_MOBIUS: {
+            // interpolate the coefficients from the identity matrix
+            const MobiusCoefficients* target = &stage->mobius;
+            MobiusCoefficients m = {
+                complex_create(1.0f + t * (target->a.real - 1.0f), t * target->a.imag),
+                complex_create(t * target->b.real, t * target->b.imag),
+                complex_create(t * target->c.real, t * target->c.imag),
+                complex_create(1.0f + t * (target->d.real - 1.0f), t * target->d.imag)
+            };
+            return mobius_apply(m, z);
+        }
+        case MAP_POLYGON:
+        case MAP_CURVE:
+        case MAP_CURVE_INVERSE: {
+            // numerical maps have no closed-form family, so points travel straight to their images
+            Complex w = stage->kind == MAP_POLYGON ? sc_mapping(stage->polygon, z)
+                      : stage->kind == MAP_CURVE  ? zipper_mapping(stage->zipper, z)
+                                                  : zipper_inverse_mapping(stage->zipper, z);
+            return complex_create(z.real + t * (w.real - z.real), z.imag + t * (w.imag - z.imag));
+        }
+        default:
+            return z;
     }
-    
-    for (int c = 1; c <= num_circles; c++) {
-        float radius = c * radius_step;
-        circle_start_indices[c-1] = *count;
-        
-        for (int l = 0; l < num_lines; l++) {
-            float angle = l * (2.0f * PI / num_lines);
-            Complex z = complex_create(radius * cosf(angle), radius * sinf(angle));
-            Complex w = mapping(z);
-            
-            if (complex_abs(w) < 100.0f) {
-                points[*count].z = z;
-                points[*count].w = w;
-                points[*count].num_connections = 0;
-                (*count)++;
-            }
+}
+
+// stages deform one after another: over the k-th slice of t, the first k stages are already
+// applied through their compiled prefix and only stage k is in motion
+Complex chain_homotopy(const MappingChain* chain, const ChainKernel* prefixes, Complex z, float t) {
+    if (chain->stage_count == 0) return z;
+    float s = t * chain->stage_count;
+    int k = (int)s;
+    if (k >= chain->stage_count) k = chain->stage_count - 1;
+    return stage_homotopy(&chain->stages[k], chain_kernel_eval(&prefixes[k], z), s - k);
+}
+
+typedef struct {
+    Complex* frames;  // HOMOTOPY_KEYFRAMES rows of point_count positions
+    int point_count;
+    int capacity;
+    const MappedPoint* points;
+    MappingChain chain;  // private copies, so the ui can edit its chain while the worker runs
+    ChainKernel prefixes[MAX_CHAIN_STAGES + 1];
+    atomic_int ready;  // rows fully written, in order of increasing t
+    atomic_bool cancel;
+    pthread_t worker;
+    bool running;
+} HomotopyCache;
+
+static void homotopy_fill_frame(HomotopyCache* cache, int k) {
+    float t = (float)k / (HOMOTOPY_KEYFRAMES - 1);
+    Complex* row = cache->frames + (size_t)k * cache->point_count;
+    for (int i = 0; i < cache->point_count; i++) {
+        Complex p = chain_homotopy(&cache->chain, cache->prefixes, cache->points[i].z, t);
+        if (!isfinite(p.real) || !isfinite(p.imag)) {
+            p = complex_create(cache->points[i].z.real + t * (cache->points[i].w.real - cache->points[i].z.real),
+                               cache->points[i].z.imag + t * (cache->points[i].w.imag - cache->points[i].z.imag));
         }
+        row[i] = p;
     }
-    
-    for (int c = 1; c <= num_circles; c++) {
-        int circle_start = circle_start_indices[c-1];
-        int circle_end = (c < num_circles) ? circle_start_indices[c] - 1 : *count - 1;
-        int points_in_circle = circle_end - circle_start + 1;
-        
-        for (int i = circle_start; i <= circle_end; i++) {
-            int next_idx = (i == circle_end) ? circle_start : i + 1;
-            add_connection(points, i, next_idx);
-            
-            if (c > 1) {
-                int prev_circle_start = circle_start_indices[c-2];
-                int angle_idx = (i - circle_start) % points_in_circle;
-                int prev_idx = prev_circle_start + angle_idx;
-                
-                if (prev_idx >= 0 && prev_idx < *count) {
-                    add_connection(points, i, prev_idx);
-                }
-            } else if (center_idx >= 0) {
-                add_connection(points, i, center_idx);
-            }
+}
+
+static void* homotopy_worker(void* arg) {
+    HomotopyCache* cache = (HomotopyCache*)arg;
+    for (int k = 0; k < HOMOTOPY_KEYFRAMES; k++) {
+        if (atomic_load(&cache->cancel)) break;
+        homotopy_fill_frame(cache, k);
+        atomic_store(&cache->ready, k + 1);
+    }
+    return NULL;
+}
+
+void homotopy_stop(HomotopyCache* cache) {
+    if (!cache->running) return;
+    atomic_store(&cache->cancel, true);
+    pthread_join(cache->worker, NULL);
+    cache->running = false;
+}
+
+// points must stay untouched until homotopy_stop is called
+void homotopy_start(HomotopyCache* cache, const MappedPoint* points, int count, const MappingChain* chain) {
+    homotopy_stop(cache);
+    atomic_store(&cache->ready, 0);
+    atomic_store(&cache->cancel, false);
+    if (count * HOMOTOPY_KEYFRAMES > cache->capacity) {
+        Complex* frames = (Complex*)realloc(cache->frames, (size_t)count * HOMOTOPY_KEYFRAMES * sizeof(Complex));
+        if (frames == NULL) {
+            cache->point_count = 0;
+            return;
         }
+        cache->frames = frames;
+        cache->capacity = count * HOMOTOPY_KEYFRAMES;
+    }
+    cache->points = points;
+    cache->point_count = count;
+    cache->chain = *chain;
+    chain_compile_prefixes(chain, cache->prefixes);
+    if (pthread_create(&cache->worker, NULL, homotopy_worker, cache) == 0) {
+        cache->running = true;
+    } else {
+        homotopy_worker(cache);
+    }
+}
+
+void homotopy_free(HomotopyCache* cache) {
+    homotopy_stop(cache);
+    free(cache->frames);
+    cache->frames = NULL;
+    cache->capacity = 0;
+    cache->point_count = 0;
+}
+
+// eased playback position of point i; falls back to the straight path until its keyframes are cached
+Complex homotopy_sample(HomotopyCache* cache, const MappedPoint* points, int i, float t) {
+    float s = ease_in_out_cubic(t) * (HOMOTOPY_KEYFRAMES - 1);
+    int k = (int)s;
+    if (k >= HOMOTOPY_KEYFRAMES - 1) k = HOMOTOPY_KEYFRAMES - 2;
+    if (k < 0) k = 0;
+    if (i >= cache->point_count || atomic_load(&cache->ready) < k + 2) {
+        return complex_lerp(points[i].z, points[i].w, t);
     }
+    float f = s - k;
+    Complex a = cache->frames[(size_t)k * cache->point_count + i];
+    Complex b = cache->frames[(size_t)(k + 1) * cache->point_count + i];
+    return complex_create(a.real + f * (b.real - a.real), a.imag + f * (b.imag - a.imag));
 }
 
 int main(void) {
@@ -390,10 +1919,16 @@ int main(void) {
     bool animate = false;
     float previous_animation_time = 0.0f;
     
-    const int MAX_POINTS = 6000;
-    MappedPoint* points = (MappedPoint*)malloc(MAX_POINTS * sizeof(MappedPoint));
+    MappedPoint* points = NULL;
+    int point_capacity = 0;
     int point_count = 0;
     
+    // the calling thread also works, so the pool gets one thread fewer than the cores
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    ThreadPool pool;
+    thread_pool_init(&pool, cores > 1 ? (int)(cores > 16 ? 15 : cores - 1) : 0);
+    GraphGenerator generator = {&pool, NULL, 0};
+    
     InputGraphType current_graph = GRID_PATTERN;
     const int graph_count = 4;
     const char* graph_names[graph_count] = {
@@ -414,109 +1949,327 @@ int main(void) {
     const float radialMaxRadius = 6.0f;
     const int polarCircles = 24;
     const int polarLines = 64;
+    const float ringStep = 0.4f;
+    int density = 1;                  // resolution multiplier for every input graph
+    const int maxDensity = 16;
     
-    int current_mapping = 0;
-    const int mapping_count = 5;
-    Complex (*mappings[mapping_count])(Complex) = {
-        identity_mapping,
-        square_mapping,
-        reciprocal_mapping,
-        exp_mapping,
-        mobius_mapping
-    };
+    // target of the polygon stage; p enters edit mode, clicks place vertices and enter solves
+    SchwarzChristoffel polygon_map = {0};
+    const Complex default_polygon[6] = {{-3, -3}, {3, -3}, {3, 0}, {0, 0}, {0, 3}, {-3, 3}};
+    sc_solve(&polygon_map, default_polygon, 6, radialMaxRadius);
+    Complex polygon_draft[SC_MAX_VERTICES];
+    int polygon_draft_count = 0;
+    bool editing_polygon = false;
+    const char* polygon_status = "";
+    double polygon_solve_ms = 0.0;
     
-    const char* mapping_names[mapping_count] = {
-        "identity: f(z) = z",
-        "square: f(z) = z^2",
-        "reciprocal: f(z) = 1/z",
-        "exponential: f(z) = e^z",
-        "möbius: f(z) = (az+b)/(cz+d)"
-    };
+    // target of the curve stages; c enters drawing mode and a mouse stroke is unzipped on release
+    ZipperMap zipper_map = {0};
+    const int maxStrokePoints = 4096;
+    Complex* curve_stroke = (Complex*)malloc(maxStrokePoints * sizeof(Complex));
+    int curve_stroke_count = 0;
+    bool drawing_curve = false;
+    const char* curve_status = "";
+    double curve_solve_ms = 0.0;
+    
+    // the mapping is a chain of stages edited at runtime and compiled into one kernel per change
+    MappingChain chain = {{{MAP_IDENTITY, mobius_default, &polygon_map, &zipper_map}}, 1};
+    ChainKernel chain_prefixes[MAX_CHAIN_STAGES + 1];
+    chain_compile_prefixes(&chain, chain_prefixes);
+    const ChainKernel* kernel = &chain_prefixes[chain.stage_count];
+    int selected_stage = 0;
+    int selected_coefficient = 0;  // 0..3 for a..d
+    const float coefficientStep = 0.1f;
     
-    generate_grid_points(points, &point_count, gridSpacing, gridSize, mappings[current_mapping]);
+    if (reserve_points(&points, &point_capacity, (2 * gridSize + 1) * (2 * gridSize + 1))) {
+        generate_grid_points(&generator, points, &point_count, gridSpacing, gridSize, kernel);
+    }
+    
+    WarpMesh warp;
+    bool warp_ready = warp_mesh_init(&warp, complex_create(-3.0f, -3.0f), 6.0f);
+    bool show_warp = false;
+    bool warp_dirty = true;
+    bool show_wireframe = false;
+    const int warpMaxLeaves = 4096;
+    const float warpTolerancePixels = 0.5f;
+    
+    HomotopyCache homotopy = {0};
+    bool use_homotopy = false;
+    const Rectangle timeline = {20, screenHeight - 90, screenWidth - 40, 12};
+    
+    KdTree hover_tree = {0};
+    kdtree_build(&hover_tree, points, point_count);
+    const int MAX_BRUSH_HITS = 4096;
+    int* brush_hits = (int*)malloc(MAX_BRUSH_HITS * sizeof(int));
+    const float hoverPickPixels = 12.0f;
+    const float brushRadius = 0.5f;
+    
+    // with event waiting on, EndDrawing sleeps until the next input; frames keep coming only
+    // while the animation runs or the homotopy worker is still filling keyframes
+    RenderTexture2D scene = LoadRenderTexture(screenWidth, screenHeight);
+    bool scene_drawn = false;
+    int homotopy_seen = 0;
     
     while (!WindowShouldClose()) {
+        bool regenerate = false;
+        bool scene_dirty = !scene_drawn || input_event_this_frame() || animate;
+        
         if (IsKeyPressed(KEY_RIGHT)) {
             current_graph = (current_graph + 1) % graph_count;
-            animation_time = 0.0f;
-            animate = true;
-            
-            switch (current_graph) {
-                case GRID_PATTERN:
-                    generate_grid_points(points, &point_count, gridSpacing, gridSize, mappings[current_mapping]);
-                    break;
-                case CONCENTRIC_CIRCLES:
-                    generate_concentric_circles(points, &point_count, circlesCount, pointsPerCircle, mappings[current_mapping]);
-                    break;
-                case RADIAL_LINES:
-                    generate_radial_lines(points, &point_count, radialLines, pointsPerRadial, radialMaxRadius, mappings[current_mapping]);
-                    break;
-                case POLAR_GRID:
-                    generate_polar_grid(points, &point_count, polarCircles, polarLines, mappings[current_mapping]);
-                    break;
-            }
+            regenerate = true;
         }
         
         if (IsKeyPressed(KEY_LEFT)) {
             current_graph = (current_graph - 1 + graph_count) % graph_count;
-            animation_time = 0.0f;
-            animate = true;
-            
-            switch (current_graph) {
-                case GRID_PATTERN:
-                    generate_grid_points(points, &point_count, gridSpacing, gridSize, mappings[current_mapping]);
-                    break;
-                case CONCENTRIC_CIRCLES:
-                    generate_concentric_circles(points, &point_count, circlesCount, pointsPerCircle, mappings[current_mapping]);
-                    break;
-                case RADIAL_LINES:
-                    generate_radial_lines(points, &point_count, radialLines, pointsPerRadial, radialMaxRadius, mappings[current_mapping]);
-                    break;
-                case POLAR_GRID:
-                    generate_polar_grid(points, &point_count, polarCircles, polarLines, mappings[current_mapping]);
-                    break;
-            }
+            regenerate = true;
         }
         
+        MappingStage* stage = &chain.stages[selected_stage];
         if (IsKeyPressed(KEY_DOWN)) {
-            current_mapping = (current_mapping + 1) % mapping_count;
+            stage->kind = (stage->kind + 1) % MAP_KIND_COUNT;
+            regenerate = true;
+        }
+        
+        if (IsKeyPressed(KEY_UP)) {
+            stage->kind = (stage->kind - 1 + MAP_KIND_COUNT) % MAP_KIND_COUNT;
+            regenerate = true;
+        }
+        
+        if (IsKeyPressed(KEY_N) && chain.stage_count < MAX_CHAIN_STAGES) {
+            chain.stages[chain.stage_count] = (MappingStage){MAP_IDENTITY, mobius_default, &polygon_map, &zipper_map};
+            selected_stage = chain.stage_count++;
+            regenerate = true;
+        }
+        
+        if (IsKeyPressed(KEY_BACKSPACE) && !editing_polygon && chain.stage_count > 1) {
+            for (int s = selected_stage; s < chain.stage_count - 1; s++) {
+                chain.stages[s] = chain.stages[s + 1];
+            }
+            chain.stage_count--;
+            if (selected_stage >= chain.stage_count) selected_stage = chain.stage_count - 1;
+            regenerate = true;
+        }
+        
+        if (IsKeyPressed(KEY_TAB)) {
+            selected_stage = (selected_stage + 1) % chain.stage_count;
+        }
+        
+        if (IsKeyPressed(KEY_C)) {
+            drawing_curve = !drawing_curve;
+            editing_polygon = false;
+            curve_stroke_count = 0;
+            curve_status = "";
+        }
+        
+        if (drawing_curve) {
+            Vector2 mouse = GetMousePosition();
+            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                curve_stroke_count = 0;
+            }
+            if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && curve_stroke_count < maxStrokePoints) {
+                Vector2 last = curve_stroke_count > 0 ? complex_to_screen(curve_stroke[curve_stroke_count - 1], center, scale) : (Vector2){-100, -100};
+                if (fabsf(mouse.x - last.x) + fabsf(mouse.y - last.y) >= 3.0f) {
+                    curve_stroke[curve_stroke_count++] = screen_to_complex(mouse, center, scale);
+                }
+            }
+            if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && curve_stroke_count > 0) {
+                // the homotopy worker reads the map, so it stops before the map changes
+                homotopy_stop(&homotopy);
+                double started = GetTime();
+                ZipperMap candidate = {0};
+                if (zipper_solve(&candidate, curve_stroke, curve_stroke_count, radialMaxRadius) && zipper_build_grids(&candidate, &pool)) {
+                    zipper_free(&zipper_map);
+                    zipper_map = candidate;
+                    curve_solve_ms = (GetTime() - started) * 1000.0;
+                    drawing_curve = false;
+                    regenerate = true;
+                } else {
+                    zipper_free(&candidate);
+                    curve_status = "rejected: the closed stroke crosses itself";
+                    if (use_homotopy) {
+                        homotopy_start(&homotopy, points, point_count, &chain);
+                    }
+                }
+                curve_stroke_count = 0;
+            }
+        }
+        
+        if (IsKeyPressed(KEY_P)) {
+            drawing_curve = false;
+            editing_polygon = !editing_polygon;
+            polygon_draft_count = 0;
+            polygon_status = "";
+        }
+        
+        if (editing_polygon) {
+            bool on_timeline = CheckCollisionPointRec(GetMousePosition(), (Rectangle){timeline.x, timeline.y - 8, timeline.width, timeline.height + 16});
+            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !on_timeline && polygon_draft_count < SC_MAX_VERTICES) {
+                polygon_draft[polygon_draft_count++] = screen_to_complex(GetMousePosition(), center, scale);
+            }
+            if (IsKeyPressed(KEY_BACKSPACE) && polygon_draft_count > 0) {
+                polygon_draft_count--;
+            }
+            if (IsKeyPressed(KEY_ENTER)) {
+                // the homotopy worker reads the polygon, so it stops before the map changes
+                homotopy_stop(&homotopy);
+                double started = GetTime();
+                SchwarzChristoffel candidate;
+                if (sc_solve(&candidate, polygon_draft, polygon_draft_count, radialMaxRadius)) {
+                    polygon_map = candidate;
+                    polygon_solve_ms = (GetTime() - started) * 1000.0;
+                    polygon_status = "solved";
+                    editing_polygon = false;
+                    regenerate = true;
+                } else {
+                    polygon_status = "rejected: needs 3+ vertices and a simple outline";
+                    if (use_homotopy) {
+                        homotopy_start(&homotopy, points, point_count, &chain);
+                    }
+                }
+            }
+        }
+        
+        // coefficient edits only recompile and remap; the animation keeps its place
+        bool coefficients_edited = false;
+        stage = &chain.stages[selected_stage];
+        if (stage->kind == MAP_MOBIUS) {
+            for (int k = 0; k < 4; k++) {
+                if (IsKeyPressed(KEY_ONE + k)) selected_coefficient = k;
+            }
+            Complex* coefficients[4] = {&stage->mobius.a, &stage->mobius.b, &stage->mobius.c, &stage->mobius.d};
+            Complex* coefficient = coefficients[selected_coefficient];
+            if (IsKeyPressed(KEY_L)) { coefficient->real += coefficientStep; coefficients_edited = true; }
+            if (IsKeyPressed(KEY_J)) { coefficient->real -= coefficientStep; coefficients_edited = true; }
+            if (IsKeyPressed(KEY_I)) { coefficient->imag += coefficientStep; coefficients_edited = true; }
+            if (IsKeyPressed(KEY_K)) { coefficient->imag -= coefficientStep; coefficients_edited = true; }
+            if (IsKeyPressed(KEY_R)) { stage->mobius = mobius_default; coefficients_edited = true; }
+        }
+        
+        if (IsKeyPressed(KEY_EQUAL) && density < maxDensity) {
+            density *= 2;
+            regenerate = true;
+        }
+        
+        if (IsKeyPressed(KEY_MINUS) && density > 1) {
+            density /= 2;
+            regenerate = true;
+        }
+        
+        if (IsKeyPressed(KEY_T)) {
+            show_warp = !show_warp;
             animation_time = 0.0f;
             animate = true;
-            
-            switch (current_graph) {
-                case GRID_PATTERN:
-                    generate_grid_points(points, &point_count, gridSpacing, gridSize, mappings[current_mapping]);
-                    break;
-                case CONCENTRIC_CIRCLES:
-                    generate_concentric_circles(points, &point_count, circlesCount, pointsPerCircle, mappings[current_mapping]);
-                    break;
-                case RADIAL_LINES:
-                    generate_radial_lines(points, &point_count, radialLines, pointsPerRadial, radialMaxRadius, mappings[current_mapping]);
-                    break;
-                case POLAR_GRID:
-                    generate_polar_grid(points, &point_count, polarCircles, polarLines, mappings[current_mapping]);
-                    break;
+        }
+        
+        if (IsKeyPressed(KEY_G)) {
+            show_wireframe = !show_wireframe;
+        }
+        
+        if (IsFileDropped()) {
+            FilePathList dropped = LoadDroppedFiles();
+            if (dropped.count > 0 && warp_ready) {
+                Image image = LoadImage(dropped.paths[0]);
+                if (image.data != NULL) {
+                    warp_mesh_set_image(&warp, image);
+                    UnloadImage(image);
+                    show_warp = true;
+                }
             }
+            UnloadDroppedFiles(dropped);
         }
         
-        if (IsKeyPressed(KEY_UP)) {
-            current_mapping = (current_mapping - 1 + mapping_count) % mapping_count;
+        if (IsKeyPressed(KEY_H)) {
+            use_homotopy = !use_homotopy;
             animation_time = 0.0f;
             animate = true;
+            if (use_homotopy) {
+                homotopy_start(&homotopy, points, point_count, &chain);
+            } else {
+                homotopy_stop(&homotopy);
+            }
+        }
+        
+        // scrubbing only reads cached keyframes, so it is independent of the mapping's cost
+        bool scrubbing = IsMouseButtonDown(MOUSE_LEFT_BUTTON) &&
+                         CheckCollisionPointRec(GetMousePosition(), (Rectangle){timeline.x, timeline.y - 8, timeline.width, timeline.height + 16});
+        if (scrubbing) {
+            animation_time = fminf(fmaxf((GetMouseX() - timeline.x) / timeline.width, 0.0f), 1.0f);
+            animate = false;
+        }
+        if (IsKeyPressed(KEY_PERIOD)) {
+            animation_time = fminf(animation_time + 1.0f / (HOMOTOPY_KEYFRAMES - 1), 1.0f);
+            animate = false;
+        }
+        if (IsKeyPressed(KEY_COMMA)) {
+            animation_time = fmaxf(animation_time - 1.0f / (HOMOTOPY_KEYFRAMES - 1), 0.0f);
+            animate = false;
+        }
+        
+        if (regenerate || coefficients_edited) {
+            // the homotopy worker reads the map, so it stops before the blob solve changes it
+            homotopy_stop(&homotopy);
+            // the curve stages start from a default blob until a curve is drawn
+            for (int s = 0; s < chain.stage_count && !zipper_map.solved; s++) {
+                if (chain.stages[s].kind != MAP_CURVE && chain.stages[s].kind != MAP_CURVE_INVERSE) continue;
+                Complex blob[256];
+                for (int k = 0; k < 256; k++) {
+                    float angle = k * 2.0f * PI / 256;
+                    float radius = 3.0f + 0.8f * sinf(3.0f * angle) + 0.3f * cosf(5.0f * angle);
+                    blob[k] = complex_create(radius * cosf(angle), radius * sinf(angle));
+                }
+                double started = GetTime();
+                if (zipper_solve(&zipper_map, blob, 256, radialMaxRadius)) {
+                    zipper_build_grids(&zipper_map, &pool);
+                }
+                curve_solve_ms = (GetTime() - started) * 1000.0;
+            }
+            chain_compile_prefixes(&chain, chain_prefixes);
+            kernel = &chain_prefixes[chain.stage_count];
+            warp_dirty = true;
+            if (regenerate) {
+                animation_time = 0.0f;
+                animate = true;
+            }
             
+            point_count = 0;
             switch (current_graph) {
-                case GRID_PATTERN:
-                    generate_grid_points(points, &point_count, gridSpacing, gridSize, mappings[current_mapping]);
+                case GRID_PATTERN: {
+                    int size = gridSize * density;
+                    if (reserve_points(&points, &point_capacity, (2 * size + 1) * (2 * size + 1))) {
+                        generate_grid_points(&generator, points, &point_count, gridSpacing / density, size, kernel);
+                    }
                     break;
-                case CONCENTRIC_CIRCLES:
-                    generate_concentric_circles(points, &point_count, circlesCount, pointsPerCircle, mappings[current_mapping]);
+                }
+                case CONCENTRIC_CIRCLES: {
+                    int rings = circlesCount * density;
+                    int per_ring = pointsPerCircle * density;
+                    if (reserve_points(&points, &point_capacity, 1 + rings * per_ring)) {
+                        generate_concentric_circles(&generator, points, &point_count, rings, per_ring, ringStep / density, kernel);
+                    }
                     break;
-                case RADIAL_LINES:
-                    generate_radial_lines(points, &point_count, radialLines, pointsPerRadial, radialMaxRadius, mappings[current_mapping]);
+                }
+                case RADIAL_LINES: {
+                    int lines = radialLines * density;
+                    int per_line = pointsPerRadial * density;
+                    if (reserve_points(&points, &point_capacity, 1 + lines * per_line)) {
+                        generate_radial_lines(&generator, points, &point_count, lines, per_line, radialMaxRadius, kernel);
+                    }
                     break;
-                case POLAR_GRID:
-                    generate_polar_grid(points, &point_count, polarCircles, polarLines, mappings[current_mapping]);
+                }
+                case POLAR_GRID: {
+                    int rings = polarCircles * density;
+                    int lines = polarLines * density;
+                    if (reserve_points(&points, &point_capacity, 1 + rings * lines)) {
+                        generate_polar_grid(&generator, points, &point_count, rings, lines, ringStep / density, kernel);
+                    }
                     break;
+                }
+            }
+            
+            // rebuild the inverse-lookup tree over the new image positions
+            kdtree_build(&hover_tree, points, point_count);
+            if (use_homotopy) {
+                homotopy_start(&homotopy, points, point_count, &chain);
             }
         }
         
@@ -535,40 +2288,132 @@ int main(void) {
             }
         }
         
-        BeginDrawing();
-        ClearBackground(BLACK);
+        bool homotopy_pending = homotopy.running && atomic_load(&homotopy.ready) < HOMOTOPY_KEYFRAMES;
+        if (animate || homotopy_pending) {
+            DisableEventWaiting();
+        } else {
+            EnableEventWaiting();
+        }
+        scene_dirty = scene_dirty || atomic_load(&homotopy.ready) != homotopy_seen;
+        
+        // the mapped graph, outlines and timeline are drawn into the scene texture only when
+        // something changed; the cursor readouts are drawn over it every frame
+        if (scene_dirty) {
+            BeginTextureMode(scene);
+            ClearBackground(BLACK);
         
-        DrawText("animated conformal mapping", 20, 20, 20, WHITE);
-        DrawText("left/right: change input graph   up/down: change mapping   space: toggle animation", 20, 50, 15, GRAY);
-        DrawText(TextFormat("input: %s    mapping: %s", graph_names[current_graph], mapping_names[current_mapping]), 20, 80, 18, SKYBLUE);
-        DrawText(TextFormat("animation: %s   progress: %.0f%%", animate ? "ON" : "OFF", animation_time * 100), 20, 110, 15, GRAY);
+            DrawText("animated conformal mapping", 20, 20, 20, WHITE);
+            DrawText("left/right: change input graph   up/down: change stage   space: toggle animation", 20, 50, 15, GRAY);
+            DrawText(TextFormat("input: %s    f: %s", graph_names[current_graph], chain_describe(&chain, selected_stage)), 20, 80, 18, SKYBLUE);
+            DrawText(TextFormat("animation: %s   progress: %.0f%%   points: %d   density: %dx (-/=)", animate ? "ON" : "OFF",
+                                animation_time * 100, point_count, density), 20, 110, 15, GRAY);
+            DrawText("hover: preimage under the cursor   hold mouse: preimage brush   t: textured warp   g: wireframe", 20, 130, 15, GRAY);
+            DrawText("n: add stage   backspace: remove stage   tab: select stage   p: draw polygon   c: draw curve", 20, 170, 15, GRAY);
+            if (chain.stages[selected_stage].kind == MAP_MOBIUS) {
+                MobiusCoefficients m = chain.stages[selected_stage].mobius;
+                DrawText(TextFormat("a = %.1f%+.1fi   b = %.1f%+.1fi   c = %.1f%+.1fi   d = %.1f%+.1fi", m.a.real, m.a.imag,
+                                    m.b.real, m.b.imag, m.c.real, m.c.imag, m.d.real, m.d.imag), 20, 190, 15, SKYBLUE);
+                DrawText(TextFormat("1-4: pick %c   j/l: real -/+   i/k: imaginary +/-   r: reset", 'a' + selected_coefficient), 20, 210, 15, GRAY);
+            }
+        
+            DrawLine(0, center.y, screenWidth, center.y, (Color){50, 50, 50, 255});
+            DrawLine(center.x, 0, center.x, screenHeight, (Color){50, 50, 50, 255});
         
-        DrawLine(0, center.y, screenWidth, center.y, (Color){50, 50, 50, 255});
-        DrawLine(center.x, 0, center.x, screenHeight, (Color){50, 50, 50, 255});
+            if (show_warp && warp_ready) {
+                if (warp_dirty) {
+                    warp_mesh_build(&warp, kernel, scale, warpTolerancePixels, warpMaxLeaves);
+                    warp_dirty = false;
+                }
+                warp_mesh_draw(&warp, animation_time, center, scale, show_wireframe);
+                DrawText(TextFormat("warp mesh: %d triangles, %d vertices", warp.index_count / 3, warp.vertex_count), 20, 150, 15, GRAY);
+            }
         
-        for (int i = 0; i < point_count; i++) {
-            Complex p1 = complex_lerp(points[i].z, points[i].w, animation_time);
-            Vector2 screen_p1 = complex_to_screen(p1, center, scale);
+            for (int i = 0; !show_warp && i < point_count; i++) {
+                Complex p1 = use_homotopy ? homotopy_sample(&homotopy, points, i, animation_time)
+                                          : complex_lerp(points[i].z, points[i].w, animation_time);
+                Vector2 screen_p1 = complex_to_screen(p1, center, scale);
             
-            for (int c = 0; c < points[i].num_connections; c++) {
-                int connect_idx = points[i].connections[c];
-                if (i < connect_idx) {
-                    Complex p2 = complex_lerp(points[connect_idx].z, points[connect_idx].w, animation_time);
-                    Vector2 screen_p2 = complex_to_screen(p2, center, scale);
+                for (int c = 0; c < points[i].num_connections; c++) {
+                    int connect_idx = points[i].connections[c];
+                    if (i < connect_idx) {
+                        Complex p2 = use_homotopy ? homotopy_sample(&homotopy, points, connect_idx, animation_time)
+                                                  : complex_lerp(points[connect_idx].z, points[connect_idx].w, animation_time);
+                        Vector2 screen_p2 = complex_to_screen(p2, center, scale);
                     
-                    DrawLineEx(screen_p1, screen_p2, 1.0f, (Color){30, 30, 80, 255});
+                        DrawLineEx(screen_p1, screen_p2, 1.0f, (Color){30, 30, 80, 255});
+                    }
                 }
             }
-        }
         
-        for (int i = 0; i < point_count; i++) {
-            Complex interpolated = complex_lerp(points[i].z, points[i].w, animation_time);
-            draw_complex_circle(interpolated, circleRadius, SKYBLUE, center, scale);
+            for (int i = 0; !show_warp && i < point_count; i++) {
+                Complex interpolated = use_homotopy ? homotopy_sample(&homotopy, points, i, animation_time)
+                                                    : complex_lerp(points[i].z, points[i].w, animation_time);
+                draw_complex_circle(interpolated, circleRadius, SKYBLUE, center, scale);
+            }
+        
+            bool polygon_in_chain = false;
+            bool curve_in_chain = false;
+            for (int s = 0; s < chain.stage_count; s++) {
+                if (chain.stages[s].kind == MAP_POLYGON) polygon_in_chain = true;
+                if (chain.stages[s].kind == MAP_CURVE || chain.stages[s].kind == MAP_CURVE_INVERSE) curve_in_chain = true;
+            }
+            if (curve_in_chain && zipper_map.solved && !drawing_curve) {
+                for (int k = 0; k < zipper_map.n; k++) {
+                    double complex a = zipper_map.curve[k], b = zipper_map.curve[(k + 1) % zipper_map.n];
+                    DrawLineEx(complex_to_screen(complex_create(creal(a), cimag(a)), center, scale),
+                               complex_to_screen(complex_create(creal(b), cimag(b)), center, scale), 2.0f, VIOLET);
+                }
+                DrawCircleLines(center.x, center.y, zipper_map.domain_radius * scale, DARKPURPLE);
+                DrawText(TextFormat("curve: %d boundary points, unzipped and cached in %.0f ms", zipper_map.n, curve_solve_ms),
+                         20, 270, 15, VIOLET);
+            }
+            if (drawing_curve) {
+                for (int k = 0; k + 1 < curve_stroke_count; k++) {
+                    DrawLineEx(complex_to_screen(curve_stroke[k], center, scale), complex_to_screen(curve_stroke[k + 1], center, scale), 2.0f, YELLOW);
+                }
+                DrawText(TextFormat("drawing curve: drag a closed loop, release to map it, c: cancel   %s", curve_status), 20, 250, 15, YELLOW);
+            }
+            if ((polygon_in_chain || editing_polygon) && polygon_map.solved) {
+                for (int k = 0; k < polygon_map.n; k++) {
+                    double complex a = polygon_map.w[k], b = polygon_map.w[(k + 1) % polygon_map.n];
+                    DrawLineEx(complex_to_screen(complex_create(creal(a), cimag(a)), center, scale),
+                               complex_to_screen(complex_create(creal(b), cimag(b)), center, scale), 2.0f, GREEN);
+                }
+                DrawCircleLines(center.x, center.y, polygon_map.domain_radius * scale, DARKGREEN);
+                DrawText(TextFormat("polygon: %d vertices, %d newton steps, %.1f ms", polygon_map.n, polygon_map.iterations, polygon_solve_ms),
+                         20, 230, 15, GREEN);
+            }
+            if (editing_polygon) {
+                for (int k = 0; k < polygon_draft_count; k++) {
+                    Vector2 a = complex_to_screen(polygon_draft[k], center, scale);
+                    DrawCircleV(a, 4.0f, YELLOW);
+                    if (k + 1 < polygon_draft_count) DrawLineEx(a, complex_to_screen(polygon_draft[k + 1], center, scale), 2.0f, YELLOW);
+                }
+                DrawText(TextFormat("drawing polygon: click to add vertices (%d), backspace: undo, enter: solve, p: cancel   %s",
+                                    polygon_draft_count, polygon_status), 20, 250, 15, YELLOW);
+            }
+        
+            DrawRectangleRec(timeline, (Color){40, 40, 40, 255});
+            for (int k = 0; k < HOMOTOPY_KEYFRAMES; k++) {
+                float x = timeline.x + timeline.width * k / (HOMOTOPY_KEYFRAMES - 1);
+                bool cached = use_homotopy && k < atomic_load(&homotopy.ready);
+                DrawLine(x, timeline.y, x, timeline.y + timeline.height, cached ? SKYBLUE : GRAY);
+            }
+            DrawRectangle(timeline.x + timeline.width * animation_time - 2, timeline.y - 4, 4, timeline.height + 8, PINK);
+            DrawText(TextFormat("path: %s   h: toggle homotopy   ,/.: step keyframes   drag bar: scrub",
+                                use_homotopy ? "homotopy f_t(z)" : "straight line"), 20, screenHeight - 110, 15, GRAY);
+            EndTextureMode();
+            scene_drawn = true;
+            homotopy_seen = atomic_load(&homotopy.ready);
         }
         
+        BeginDrawing();
+        ClearBackground(BLACK);
+        scene_texture_draw(scene);
+        
         Vector2 mouse_pos = GetMousePosition();
         Complex z = screen_to_complex(mouse_pos, center, scale);
-        Complex w = mappings[current_mapping](z);
+        Complex w = chain_kernel_eval(kernel, z);
         
         char z_text[50];
         sprintf(z_text, "z = %.2f + %.2fi", z.real, z.imag);
@@ -581,9 +2426,45 @@ int main(void) {
         Complex interpolated = complex_lerp(z, w, animation_time);
         draw_complex_circle(interpolated, circleRadius * 2.5f, PINK, center, scale);
         
+        // inverse lookup: the cursor is read as a w-plane position and matched against the mapped points
+        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && !scrubbing && !editing_polygon && !drawing_curve) {
+            int hits = kdtree_radius(&hover_tree, points, z, brushRadius, brush_hits, MAX_BRUSH_HITS);
+            int shown = hits < MAX_BRUSH_HITS ? hits : MAX_BRUSH_HITS;
+            for (int h = 0; h < shown; h++) {
+                draw_complex_circle(points[brush_hits[h]].z, circleRadius * 1.5f, ORANGE, center, scale);
+            }
+            DrawCircleLines(mouse_pos.x, mouse_pos.y, brushRadius * scale, ORANGE);
+            DrawText(TextFormat("brush: %d preimages within %.2f", hits, brushRadius), 20, screenHeight - 60, 15, ORANGE);
+        } else {
+            int hovered = kdtree_nearest(&hover_tree, points, z, hoverPickPixels / scale);
+            if (hovered >= 0) {
+                MappedPoint* hp = &points[hovered];
+                for (int c = 0; c < hp->num_connections; c++) {
+                    MappedPoint* np = &points[hp->connections[c]];
+                    DrawLineEx(complex_to_screen(hp->z, center, scale), complex_to_screen(np->z, center, scale), 2.0f, YELLOW);
+                    DrawLineEx(complex_to_screen(hp->w, center, scale), complex_to_screen(np->w, center, scale), 2.0f, ORANGE);
+                }
+                draw_complex_circle(hp->z, circleRadius * 3.0f, YELLOW, center, scale);
+                draw_complex_circle(hp->w, circleRadius * 3.0f, ORANGE, center, scale);
+                DrawText(TextFormat("preimage of w: z = %.2f + %.2fi", hp->z.real, hp->z.imag), 20, screenHeight - 60, 15, YELLOW);
+            }
+        }
+        if (editing_polygon && polygon_draft_count > 0) {
+            DrawLineEx(complex_to_screen(polygon_draft[polygon_draft_count - 1], center, scale), mouse_pos, 2.0f, YELLOW);
+        }
+        
         EndDrawing();
     }
     
+    UnloadRenderTexture(scene);
+    homotopy_free(&homotopy);
+    if (warp_ready) warp_mesh_free(&warp);
+    kdtree_free(&hover_tree);
+    free(brush_hits);
+    free(generator.slot_index);
+    zipper_free(&zipper_map);
+    free(curve_stroke);
+    thread_pool_destroy(&pool);
     free(points);
     CloseWindow();
     
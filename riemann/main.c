@@ -0,0 +1,635 @@
+// riemann surfaces of multi-valued functions in 3d; sheets glued across branch cuts, colored by phase
+#include "raylib.h"
+#include "rlgl.h"
+#include "../common/overlay.h"
+#include <complex.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCREEN_WIDTH 1200
+#define SCREEN_HEIGHT 800
+#define MAX_SHEETS 5
+#define MAX_BRANCH_POINTS 3
+#define DOMAIN_RADIUS 2.0          // the z-plane square [-R, R]^2 under the surface
+#define REFINE_RATIO 0.5           // cells are split while larger than this times their distance to a branch point
+#define REFINE_LEVELS 8            // levels of refinement allowed below the base grid
+#define MIN_DETAIL 4
+#define MAX_DETAIL 9               // base grid of 2^detail cells a side
+#define CHUNK_VERTICES 65535       // raylib meshes index with unsigned short
+#define CHUNK_INDICES (12 * CHUNK_VERTICES)
+
+typedef enum {
+    SURFACE_SQRT,
+    SURFACE_LOG,
+    SURFACE_CUBIC_SQRT,
+    SURFACE_COUNT
+} SurfaceFunction;
+
+const char* surface_names[] = {
+    "sqrt(z)",
+    "log(z)",
+    "(z^3 - 1)^(1/2)",
+};
+
+typedef enum {
+    COLOR_PHASE,
+    COLOR_SHEET
+} ColoringMode;
+
+typedef struct {
+    ColoringMode mode;
+    float saturation;
+    bool modulus_bands;
+    bool shading;
+} ColoringParams;
+
+// every value of f at z, one per sheet; the order is arbitrary, the mesh builder glues sheets
+// by continuity rather than by index
+int surface_branches(SurfaceFunction function, double complex z, double complex* w) {
+    switch (function) {
+        case SURFACE_SQRT: {
+            double complex root = csqrt(z);
+            w[0] = root;
+            w[1] = -root;
+            return 2;
+        }
+        case SURFACE_LOG: {
+            double complex principal = clog(z);
+            for (int k = 0; k < MAX_SHEETS; k++) {
+                w[k] = principal + 2.0 * M_PI * I * (k - MAX_SHEETS / 2);
+            }
+            return MAX_SHEETS;
+        }
+        case SURFACE_CUBIC_SQRT: {
+            double complex root = csqrt(z * z * z - 1.0);
+            w[0] = root;
+            w[1] = -root;
+            return 2;
+        }
+        default:
+            return 0;
+    }
+}
+
+int surface_sheets(SurfaceFunction function) {
+    return function == SURFACE_LOG ? MAX_SHEETS : 2;
+}
+
+int surface_branch_points(SurfaceFunction function, double complex* points) {
+    if (function == SURFACE_CUBIC_SQRT) {
+        for (int k = 0; k < 3; k++) points[k] = cexp(2.0 * M_PI * I * k / 3.0);
+        return 3;
+    }
+    points[0] = 0.0;
+    return 1;
+}
+
+// height above the z-plane: re w for the square roots, im w for log, whose real part runs off
+// to -infinity at the branch point while the imaginary part climbs one turn per sheet
+float surface_height(SurfaceFunction function, double complex w) {
+    switch (function) {
+        case SURFACE_LOG:
+            return (float)(0.2 * cimag(w));
+        case SURFACE_CUBIC_SQRT:
+            return (float)(0.6 * creal(w));
+        default:
+            return (float)creal(w);
+    }
+}
+
+Color phase_to_color_hsv(double phase, float saturation, float value) {
+    float hue = (float)(fmod(phase + M_PI, 2*M_PI) * 180.0 / M_PI);
+    return ColorFromHSV(hue, saturation, value);
+}
+
+// the z-plane mesh: an adaptive quadtree over the domain, leaves triangulated without cracks.
+// points live on a lattice 2^levels a side, so a hash on lattice coordinates finds the
+// corners neighbouring leaves share and the hanging midpoints of their finer neighbours
+typedef struct {
+    int levels;
+    double complex* points;
+    int point_count;
+    int point_capacity;
+    int* triangles;            // three point indices each, counterclockwise in z
+    int triangle_count;
+    int triangle_capacity;
+    uint64_t* keys;            // lattice key + 1, 0 for an empty slot
+    int* slots;
+    uint64_t hash_mask;
+} PlaneMesh;
+
+typedef struct {
+    int x, y, size;            // lattice units
+} Leaf;
+
+static uint64_t plane_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// index of the lattice point (x, y), or -1 when it is not in the mesh and insert is false
+static int plane_point(PlaneMesh* mesh, int x, int y, bool insert) {
+    uint64_t key = ((uint64_t)x << 32 | (uint64_t)y) + 1;
+    uint64_t slot = plane_hash(key) & mesh->hash_mask;
+    while (mesh->keys[slot] != 0) {
+        if (mesh->keys[slot] == key) return mesh->slots[slot];
+        slot = (slot + 1) & mesh->hash_mask;
+    }
+    if (!insert) return -1;
+    if (mesh->point_count == mesh->point_capacity) {
+        mesh->point_capacity *= 2;
+        mesh->points = realloc(mesh->points, sizeof(double complex) * mesh->point_capacity);
+    }
+    double step = 2.0 * DOMAIN_RADIUS / (1 << mesh->levels);
+    mesh->points[mesh->point_count] = (-DOMAIN_RADIUS + x * step) + (-DOMAIN_RADIUS + y * step) * I;
+    mesh->keys[slot] = key;
+    mesh->slots[slot] = mesh->point_count;
+    return mesh->point_count++;
+}
+
+static void plane_triangle(PlaneMesh* mesh, int a, int b, int c) {
+    if (mesh->triangle_count == mesh->triangle_capacity) {
+        mesh->triangle_capacity *= 2;
+        mesh->triangles = realloc(mesh->triangles, sizeof(int) * 3 * mesh->triangle_capacity);
+    }
+    int* triangle = &mesh->triangles[3 * mesh->triangle_count++];
+    triangle[0] = a;
+    triangle[1] = b;
+    triangle[2] = c;
+}
+
+static double distance_to_cell(double complex p, double x0, double y0, double x1, double y1) {
+    double dx = fmax(fmax(x0 - creal(p), creal(p) - x1), 0.0);
+    double dy = fmax(fmax(y0 - cimag(p), cimag(p) - y1), 0.0);
+    return hypot(dx, dy);
+}
+
+static void collect_leaves(Leaf** leaves, int* count, int* capacity, int x, int y, int size, int depth, int detail,
+                           int levels, const double complex* branch_points, int branch_count) {
+    double step = 2.0 * DOMAIN_RADIUS / (1 << levels);
+    double x0 = -DOMAIN_RADIUS + x * step, y0 = -DOMAIN_RADIUS + y * step;
+    double width = size * step;
+    bool split = depth < detail;
+    for (int k = 0; !split && size > 1 && k < branch_count; k++) {
+        split = width > REFINE_RATIO * distance_to_cell(branch_points[k], x0, y0, x0 + width, y0 + width);
+    }
+    if (split && size > 1) {
+        int half = size / 2;
+        collect_leaves(leaves, count, capacity, x, y, half, depth + 1, detail, levels, branch_points, branch_count);
+        collect_leaves(leaves, count, capacity, x + half, y, half, depth + 1, detail, levels, branch_points, branch_count);
+        collect_leaves(leaves, count, capacity, x, y + half, half, depth + 1, detail, levels, branch_points, branch_count);
+        collect_leaves(leaves, count, capacity, x + half, y + half, half, depth + 1, detail, levels, branch_points, branch_count);
+        return;
+    }
+    if (*count == *capacity) {
+        *capacity *= 2;
+        *leaves = realloc(*leaves, sizeof(Leaf) * *capacity);
+    }
+    (*leaves)[(*count)++] = (Leaf){ x, y, size };
+}
+
+// the points along one leaf edge from a up to (not including) b: a finer neighbour always
+// puts a point at the midpoint, so recursing only where one exists finds them all
+static void collect_edge(PlaneMesh* mesh, int ax, int ay, int bx, int by, int* polygon, int* count) {
+    int length = abs(bx - ax) + abs(by - ay);
+    if (length >= 2) {
+        int mx = (ax + bx) / 2, my = (ay + by) / 2;
+        if (plane_point(mesh, mx, my, false) >= 0) {
+            collect_edge(mesh, ax, ay, mx, my, polygon, count);
+            collect_edge(mesh, mx, my, bx, by, polygon, count);
+            return;
+        }
+    }
+    polygon[(*count)++] = plane_point(mesh, ax, ay, false);
+}
+
+// quadtree down to the base grid everywhere and up to REFINE_LEVELS further near branch points;
+// a plain leaf is two triangles, one with hanging points on its edges a fan from its centre
+PlaneMesh build_plane_mesh(SurfaceFunction function, int detail) {
+    PlaneMesh mesh = { 0 };
+    mesh.levels = detail + REFINE_LEVELS;
+    double complex branch_points[MAX_BRANCH_POINTS];
+    int branch_count = surface_branch_points(function, branch_points);
+    int leaf_capacity = 1 << (2 * detail), leaf_count = 0;
+    Leaf* leaves = malloc(sizeof(Leaf) * leaf_capacity);
+    collect_leaves(&leaves, &leaf_count, &leaf_capacity, 0, 0, 1 << mesh.levels, 0, detail, mesh.levels,
+                   branch_points, branch_count);
+    uint64_t table = 1;
+    while (table < 4ULL * (uint64_t)leaf_count + 64) table <<= 1;
+    mesh.hash_mask = table - 1;
+    mesh.keys = calloc(table, sizeof(uint64_t));
+    mesh.slots = malloc(sizeof(int) * table);
+    mesh.point_capacity = leaf_count + 64;
+    mesh.points = malloc(sizeof(double complex) * mesh.point_capacity);
+    mesh.triangle_capacity = 2 * leaf_count + 64;
+    mesh.triangles = malloc(sizeof(int) * 3 * mesh.triangle_capacity);
+    for (int k = 0; k < leaf_count; k++) {
+        Leaf leaf = leaves[k];
+        plane_point(&mesh, leaf.x, leaf.y, true);
+        plane_point(&mesh, leaf.x + leaf.size, leaf.y, true);
+        plane_point(&mesh, leaf.x + leaf.size, leaf.y + leaf.size, true);
+        plane_point(&mesh, leaf.x, leaf.y + leaf.size, true);
+    }
+    // 4 * 2^REFINE_LEVELS bounds the points on a leaf boundary
+    int* polygon = malloc(sizeof(int) * (4 << REFINE_LEVELS));
+    for (int k = 0; k < leaf_count; k++) {
+        Leaf leaf = leaves[k];
+        int x0 = leaf.x, y0 = leaf.y, x1 = leaf.x + leaf.size, y1 = leaf.y + leaf.size;
+        int count = 0;
+        collect_edge(&mesh, x0, y0, x1, y0, polygon, &count);
+        collect_edge(&mesh, x1, y0, x1, y1, polygon, &count);
+        collect_edge(&mesh, x1, y1, x0, y1, polygon, &count);
+        collect_edge(&mesh, x0, y1, x0, y0, polygon, &count);
+        if (count == 4) {
+            plane_triangle(&mesh, polygon[0], polygon[1], polygon[2]);
+            plane_triangle(&mesh, polygon[0], polygon[2], polygon[3]);
+        } else {
+            int center = plane_point(&mesh, leaf.x + leaf.size / 2, leaf.y + leaf.size / 2, true);
+            for (int i = 0; i < count; i++) {
+                plane_triangle(&mesh, center, polygon[i], polygon[(i + 1) % count]);
+            }
+        }
+    }
+    free(polygon);
+    free(leaves);
+    free(mesh.keys);
+    free(mesh.slots);
+    mesh.keys = NULL;
+    mesh.slots = NULL;
+    return mesh;
+}
+
+void free_plane_mesh(PlaneMesh* mesh) {
+    free(mesh->points);
+    free(mesh->triangles);
+}
+
+// a piece of the surface small enough for 16-bit indices; source maps its vertices back to
+// the surface's, so recoloring only has to gather
+typedef struct {
+    Mesh mesh;
+    int* source;
+} SurfaceChunk;
+
+typedef struct {
+    SurfaceFunction function;
+    int detail;
+    int sheets;
+    int vertex_count;          // plane points times sheets; vertex p * sheets + k is sheet k over point p
+    double complex* values;
+    float* positions;
+    float* normals;
+    int triangle_count;
+    SurfaceChunk* chunks;
+    int chunk_count;
+    double build_milliseconds;
+    double color_milliseconds;
+} Surface;
+
+// the branch at point p closest to w, or -1 when none is clearly closest: continuation along
+// a short edge lands on the nearest value unless the edge runs off the last sheet or around
+// a branch point. where all values coincide, at the branch point itself, any will do
+static int continue_branch(const double complex* values, int sheets, int p, double complex w) {
+    const double complex* candidates = &values[p * sheets];
+    int best = -1;
+    double best_distance = INFINITY;
+    for (int k = 0; k < sheets; k++) {
+        double distance = cabs(candidates[k] - w);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = k;
+        }
+    }
+    if (best < 0 || !isfinite(best_distance)) return -1;
+    double separation = INFINITY;
+    for (int k = 0; k < sheets; k++) {
+        if (k != best) separation = fmin(separation, cabs(candidates[k] - candidates[best]));
+    }
+    if (separation <= 1e-12 * (1.0 + cabs(w))) return best;
+    return best_distance < 0.25 * separation ? best : -1;
+}
+
+static void emit_chunk(Surface* surface, int* source, int vertex_count, const unsigned short* indices, int index_count) {
+    SurfaceChunk* chunk = &surface->chunks[surface->chunk_count++];
+    memset(&chunk->mesh, 0, sizeof(Mesh));
+    chunk->mesh.vertexCount = vertex_count;
+    chunk->mesh.triangleCount = index_count / 3;
+    chunk->mesh.vertices = MemAlloc(sizeof(float) * 3 * vertex_count);
+    chunk->mesh.colors = MemAlloc(4 * vertex_count);
+    chunk->mesh.indices = MemAlloc(sizeof(unsigned short) * index_count);
+    for (int v = 0; v < vertex_count; v++) {
+        memcpy(&chunk->mesh.vertices[3 * v], &surface->positions[3 * source[v]], sizeof(float) * 3);
+    }
+    memcpy(chunk->mesh.indices, indices, sizeof(unsigned short) * index_count);
+    chunk->source = malloc(sizeof(int) * vertex_count);
+    memcpy(chunk->source, source, sizeof(int) * vertex_count);
+}
+
+// every sheet over every plane triangle, with the sheets at its other corners found by
+// continuation from the first, which glues the sheets across whatever cuts the branches
+// happen to have. positions and topology are built once here; colors are streamed later
+Surface build_surface(SurfaceFunction function, int detail) {
+    double start = GetTime();
+    Surface surface = { 0 };
+    surface.function = function;
+    surface.detail = detail;
+    surface.sheets = surface_sheets(function);
+    PlaneMesh plane = build_plane_mesh(function, detail);
+    int sheets = surface.sheets;
+    surface.vertex_count = plane.point_count * sheets;
+    surface.values = malloc(sizeof(double complex) * surface.vertex_count);
+    surface.positions = malloc(sizeof(float) * 3 * surface.vertex_count);
+    surface.normals = calloc(3 * (size_t)surface.vertex_count, sizeof(float));
+    for (int p = 0; p < plane.point_count; p++) {
+        double complex z = plane.points[p];
+        surface_branches(function, z, &surface.values[p * sheets]);
+        for (int k = 0; k < sheets; k++) {
+            float* position = &surface.positions[3 * (p * sheets + k)];
+            position[0] = (float)creal(z);
+            position[1] = surface_height(function, surface.values[p * sheets + k]);
+            position[2] = (float)-cimag(z);
+        }
+    }
+    int* triangles = malloc(sizeof(int) * 3 * (size_t)plane.triangle_count * sheets);
+    for (int k = 0; k < sheets; k++) {
+        for (int t = 0; t < plane.triangle_count; t++) {
+            const int* corner = &plane.triangles[3 * t];
+            double complex w = surface.values[corner[0] * sheets + k];
+            if (!isfinite(creal(w)) || !isfinite(cimag(w))) continue;
+            int kb = continue_branch(surface.values, sheets, corner[1], w);
+            int kc = continue_branch(surface.values, sheets, corner[2], w);
+            if (kb < 0 || kc < 0) continue;
+            // around the third edge too, or the triangle encloses a branch point
+            if (continue_branch(surface.values, sheets, corner[2], surface.values[corner[1] * sheets + kb]) != kc) continue;
+            int* triangle = &triangles[3 * surface.triangle_count++];
+            triangle[0] = corner[0] * sheets + k;
+            triangle[1] = corner[1] * sheets + kb;
+            triangle[2] = corner[2] * sheets + kc;
+        }
+    }
+    free_plane_mesh(&plane);
+    // area-weighted vertex normals, for the baked shading
+    for (int t = 0; t < surface.triangle_count; t++) {
+        const float* a = &surface.positions[3 * triangles[3 * t]];
+        const float* b = &surface.positions[3 * triangles[3 * t + 1]];
+        const float* c = &surface.positions[3 * triangles[3 * t + 2]];
+        float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        for (int j = 0; j < 3; j++) {
+            float* normal = &surface.normals[3 * triangles[3 * t + j]];
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+        }
+    }
+    for (int v = 0; v < surface.vertex_count; v++) {
+        float* normal = &surface.normals[3 * v];
+        float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0.0f) {
+            normal[0] /= length;
+            normal[1] /= length;
+            normal[2] /= length;
+        }
+    }
+    // cut the triangle list into chunks, renumbering vertices per chunk; a vertex on a chunk
+    // border is copied into both
+    int* local = malloc(sizeof(int) * surface.vertex_count);
+    for (int v = 0; v < surface.vertex_count; v++) local[v] = -1;
+    int* source = malloc(sizeof(int) * CHUNK_VERTICES);
+    unsigned short* indices = malloc(sizeof(unsigned short) * CHUNK_INDICES);
+    int chunk_capacity = 8, vertex_count = 0, index_count = 0;
+    surface.chunks = malloc(sizeof(SurfaceChunk) * chunk_capacity);
+    for (int t = 0; t <= surface.triangle_count; t++) {
+        bool last = t == surface.triangle_count;
+        if (last || vertex_count + 3 > CHUNK_VERTICES || index_count + 3 > CHUNK_INDICES) {
+            if (index_count > 0) {
+                if (surface.chunk_count == chunk_capacity) {
+                    chunk_capacity *= 2;
+                    surface.chunks = realloc(surface.chunks, sizeof(SurfaceChunk) * chunk_capacity);
+                }
+                emit_chunk(&surface, source, vertex_count, indices, index_count);
+            }
+            for (int v = 0; v < vertex_count; v++) local[source[v]] = -1;
+            vertex_count = 0;
+            index_count = 0;
+            if (last) break;
+        }
+        for (int j = 0; j < 3; j++) {
+            int vertex = triangles[3 * t + j];
+            if (local[vertex] < 0) {
+                local[vertex] = vertex_count;
+                source[vertex_count++] = vertex;
+            }
+            indices[index_count++] = (unsigned short)local[vertex];
+        }
+    }
+    free(indices);
+    free(source);
+    free(local);
+    free(triangles);
+    surface.build_milliseconds = (GetTime() - start) * 1000.0;
+    return surface;
+}
+
+void upload_surface(Surface* surface) {
+    for (int k = 0; k < surface->chunk_count; k++) {
+        UploadMesh(&surface->chunks[k].mesh, true);
+    }
+}
+
+void free_surface(Surface* surface) {
+    for (int k = 0; k < surface->chunk_count; k++) {
+        UnloadMesh(surface->chunks[k].mesh);
+        free(surface->chunks[k].source);
+    }
+    free(surface->chunks);
+    free(surface->values);
+    free(surface->positions);
+    free(surface->normals);
+    memset(surface, 0, sizeof(Surface));
+}
+
+Color surface_color(const Surface* surface, int vertex, ColoringParams params) {
+    double complex w = surface->values[vertex];
+    float value = 1.0f;
+    if (params.modulus_bands && cabs(w) > 0.0) {
+        double band = log2(cabs(w)) * 2.0;
+        value = (float)(0.7 + 0.3 * (band - floor(band)));
+    }
+    if (params.shading) {
+        // two-sided lambert against a fixed light, so it only changes with the surface
+        const float* normal = &surface->normals[3 * vertex];
+        float lambert = fabsf(0.3f * normal[0] + 0.85f * normal[1] + 0.43f * normal[2]);
+        value *= 0.35f + 0.65f * lambert;
+    }
+    if (params.mode == COLOR_SHEET) {
+        int sheet = vertex % surface->sheets;
+        return ColorFromHSV(360.0f * sheet / surface->sheets, params.saturation, value);
+    }
+    return phase_to_color_hsv(carg(w), params.saturation, value);
+}
+
+// recoloring touches only the color buffers; positions and indices stay on the gpu as built
+void color_surface(Surface* surface, ColoringParams params) {
+    double start = GetTime();
+    for (int k = 0; k < surface->chunk_count; k++) {
+        SurfaceChunk* chunk = &surface->chunks[k];
+        Color* colors = (Color*)chunk->mesh.colors;
+        for (int v = 0; v < chunk->mesh.vertexCount; v++) {
+            colors[v] = surface_color(surface, chunk->source[v], params);
+        }
+        UpdateMeshBuffer(chunk->mesh, 3, chunk->mesh.colors, 4 * chunk->mesh.vertexCount, 0);
+    }
+    surface->color_milliseconds = (GetTime() - start) * 1000.0;
+}
+
+int main(void) {
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Riemann Surfaces");
+    SetTargetFPS(60);
+
+    SurfaceFunction function = SURFACE_SQRT;
+    int detail = 7;
+    ColoringParams params = { COLOR_PHASE, 0.85f, true, true };
+    Surface surface = build_surface(function, detail);
+    upload_surface(&surface);
+    color_surface(&surface, params);
+    Material material = LoadMaterialDefault();
+    Matrix identity = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    // the camera orbits the origin; left drag turns it, the wheel moves it in and out
+    float yaw = 0.8f, pitch = 0.5f, distance = 7.0f;
+    bool spinning = false;
+    bool wireframe = false;
+    Camera3D camera = { 0 };
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 45.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    OverlayLayer hudLayer = overlay_layer_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    bool hudStale = true;
+    EnableEventWaiting();
+
+    while (!WindowShouldClose()) {
+        bool rebuild = false, recolor = false;
+        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+            Vector2 delta = GetMouseDelta();
+            yaw -= delta.x * 0.01f;
+            pitch = fminf(fmaxf(pitch + delta.y * 0.01f, -1.5f), 1.5f);
+        }
+        float wheel = GetMouseWheelMove();
+        if (wheel != 0) {
+            distance = fminf(fmaxf(distance * ((wheel > 0) ? 0.9f : 1.1f), 2.0f), 30.0f);
+        }
+        if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_LEFT)) {
+            function = (function + (IsKeyPressed(KEY_RIGHT) ? 1 : SURFACE_COUNT - 1)) % SURFACE_COUNT;
+            rebuild = true;
+        }
+        if (IsKeyPressed(KEY_EQUAL) && detail < MAX_DETAIL) {
+            detail++;
+            rebuild = true;
+        }
+        if (IsKeyPressed(KEY_MINUS) && detail > MIN_DETAIL) {
+            detail--;
+            rebuild = true;
+        }
+        if (IsKeyPressed(KEY_C)) {
+            params.mode = params.mode == COLOR_PHASE ? COLOR_SHEET : COLOR_PHASE;
+            recolor = true;
+        }
+        if (IsKeyPressed(KEY_M)) {
+            params.modulus_bands = !params.modulus_bands;
+            recolor = true;
+        }
+        if (IsKeyPressed(KEY_L)) {
+            params.shading = !params.shading;
+            recolor = true;
+        }
+        if (IsKeyPressed(KEY_LEFT_BRACKET) || IsKeyPressed(KEY_RIGHT_BRACKET)) {
+            params.saturation = fminf(fmaxf(params.saturation + (IsKeyPressed(KEY_RIGHT_BRACKET) ? 0.1f : -0.1f), 0.0f), 1.0f);
+            recolor = true;
+        }
+        if (IsKeyPressed(KEY_W)) wireframe = !wireframe;
+        if (IsKeyPressed(KEY_SPACE)) {
+            spinning = !spinning;
+            if (spinning) {
+                DisableEventWaiting();
+            } else {
+                EnableEventWaiting();
+            }
+            hudStale = true;
+        }
+        if (IsKeyPressed(KEY_R)) {
+            yaw = 0.8f;
+            pitch = 0.5f;
+            distance = 7.0f;
+        }
+        if (spinning) yaw += 0.5f * GetFrameTime();
+
+        if (rebuild) {
+            free_surface(&surface);
+            surface = build_surface(function, detail);
+            upload_surface(&surface);
+            recolor = true;
+        }
+        if (recolor) {
+            color_surface(&surface, params);
+            hudStale = true;
+        }
+        if (hudStale) {
+            overlay_layer_begin(&hudLayer);
+                DrawText(TextFormat("Function: %s   (%d sheets)", surface_names[function], surface.sheets), 10, 10, 20, WHITE);
+                DrawText(TextFormat("%d triangles, %d vertices in %d buffers, detail %d",
+                                    surface.triangle_count, surface.vertex_count, surface.chunk_count, detail),
+                         10, 40, 16, LIGHTGRAY);
+                DrawText(TextFormat("built in %.0f ms, colors streamed in %.1f ms",
+                                    surface.build_milliseconds, surface.color_milliseconds),
+                         10, 60, 16, LIGHTGRAY);
+                DrawText(TextFormat("Coloring: %s%s%s", params.mode == COLOR_PHASE ? "phase of f" : "sheet",
+                                    params.modulus_bands ? ", modulus bands" : "", params.shading ? ", shaded" : ""),
+                         10, 80, 16, LIGHTGRAY);
+                DrawText("Left/Right: function, -/=: mesh detail", 10, SCREEN_HEIGHT - 90, 16, GRAY);
+                DrawText("C: phase/sheet colors, M: modulus bands, L: shading, [/]: saturation", 10, SCREEN_HEIGHT - 70, 16, GRAY);
+                DrawText("Mouse drag: orbit, Mouse wheel: zoom, Space: spin, W: wireframe, R: reset camera", 10, SCREEN_HEIGHT - 50, 16, GRAY);
+            overlay_layer_end(&hudLayer);
+            hudStale = false;
+        }
+
+        camera.position = (Vector3){ distance * cosf(pitch) * sinf(yaw), distance * sinf(pitch), distance * cosf(pitch) * cosf(yaw) };
+        BeginDrawing();
+            ClearBackground((Color){ 20, 20, 28, 255 });
+            BeginMode3D(camera);
+                // both faces of every sheet are visible as the camera goes around
+                rlDisableBackfaceCulling();
+                if (wireframe) rlEnableWireMode();
+                for (int k = 0; k < surface.chunk_count; k++) {
+                    DrawMesh(surface.chunks[k].mesh, material, identity);
+                }
+                if (wireframe) rlDisableWireMode();
+                rlEnableBackfaceCulling();
+                // branch points as vertical lines through every sheet
+                double complex branch_points[MAX_BRANCH_POINTS];
+                int branch_count = surface_branch_points(function, branch_points);
+                for (int k = 0; k < branch_count; k++) {
+                    float x = (float)creal(branch_points[k]), z = (float)-cimag(branch_points[k]);
+                    DrawLine3D((Vector3){ x, -3.5f, z }, (Vector3){ x, 3.5f, z }, WHITE);
+                }
+            EndMode3D();
+            overlay_layer_draw(&hudLayer);
+            if (spinning) DrawFPS(SCREEN_WIDTH - 100, 10);
+        EndDrawing();
+    }
+
+    free_surface(&surface);
+    UnloadMaterial(material);
+    UnloadRenderTexture(hudLayer.target);
+    CloseWindow();
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 // taylor/laurent series visualizer; compare original vs approximation and error via domain coloring
 #include "raylib.h"
+#include "../common/overlay.h"
 #include <complex.h>
 #include <math.h>
 #include <stdio.h>
@@ -421,6 +422,12 @@ int main(void) {
     
     UpdateTexture(texture, pixels);
     
+    // a frame is the function texture plus one overlay quad; with event waiting on,
+    // EndDrawing sleeps until the next input, so an idle window costs nothing
+    OverlayLayer chromeLayer = overlay_layer_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    VisualizationParams shownParams = params;
+    EnableEventWaiting();
+    
     while (!WindowShouldClose()) {
         bool needsUpdate = false;
         if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && GetMouseY() < SCREEN_HEIGHT - 120) {
@@ -544,59 +551,68 @@ int main(void) {
             UpdateTexture(texture, pixels);
         }
         
-        BeginDrawing();
-            ClearBackground(RAYWHITE);
-            DrawTexture(texture, 0, 0, WHITE);
-            
-            if (params.view_mode == VIEW_SPLIT) {
-                DrawText("Original Function", 10, 10, 20, WHITE);
-                DrawText(params.series_type == SERIES_TAYLOR ? "Taylor Approximation" : "Laurent Series", SCREEN_WIDTH/2 + 10, 10, 20, WHITE);
+        // only panning and zooming leave the chrome as it is
+        if (!chromeLayer.drawn || params.num_terms != shownParams.num_terms || params.func_type != shownParams.func_type ||
+            params.series_type != shownParams.series_type || params.view_mode != shownParams.view_mode ||
+            params.show_phase_lines != shownParams.show_phase_lines || params.show_modulus_lines != shownParams.show_modulus_lines) {
+            overlay_layer_begin(&chromeLayer);
+                if (params.view_mode == VIEW_SPLIT) {
+                    DrawText("Original Function", 10, 10, 20, WHITE);
+                    DrawText(params.series_type == SERIES_TAYLOR ? "Taylor Approximation" : "Laurent Series", SCREEN_WIDTH/2 + 10, 10, 20, WHITE);
                 
-                DrawLine(SCREEN_WIDTH/2, 0, SCREEN_WIDTH/2, SCREEN_HEIGHT - 120, WHITE);
-            } else if (params.view_mode == VIEW_ERROR) {
-                DrawText("Error Magnitude", 10, 10, 20, WHITE);
-                draw_error_legend(SCREEN_WIDTH - 240, 10);
-            } else if (params.view_mode == VIEW_ORIGINAL) {
-                DrawText("Original Function", 10, 10, 20, WHITE);
-            } else { // VIEW_APPROXIMATION
-                DrawText(params.series_type == SERIES_TAYLOR ? "Taylor Approximation" : "Laurent Series", 10, 10, 20, WHITE);
-            }
+                    DrawLine(SCREEN_WIDTH/2, 0, SCREEN_WIDTH/2, SCREEN_HEIGHT - 120, WHITE);
+                } else if (params.view_mode == VIEW_ERROR) {
+                    DrawText("Error Magnitude", 10, 10, 20, WHITE);
+                    draw_error_legend(SCREEN_WIDTH - 240, 10);
+                } else if (params.view_mode == VIEW_ORIGINAL) {
+                    DrawText("Original Function", 10, 10, 20, WHITE);
+                } else { // VIEW_APPROXIMATION
+                    DrawText(params.series_type == SERIES_TAYLOR ? "Taylor Approximation" : "Laurent Series", 10, 10, 20, WHITE);
+                }
             
-            DrawText(TextFormat("Function: %s   Terms: %d", function_names[params.func_type], params.num_terms), 
-                     10, 40, 20, WHITE);
+                DrawText(TextFormat("Function: %s   Terms: %d", function_names[params.func_type], params.num_terms), 
+                         10, 40, 20, WHITE);
             
-            DrawRectangleRec(termButton, LIGHTGRAY);
-            DrawText(TextFormat("Terms: %d/%d", params.num_terms, MAX_TERMS), termButton.x + 10, termButton.y + 5, 20, BLACK);
+                DrawRectangleRec(termButton, LIGHTGRAY);
+                DrawText(TextFormat("Terms: %d/%d", params.num_terms, MAX_TERMS), termButton.x + 10, termButton.y + 5, 20, BLACK);
             
-            DrawRectangleRec(functionButton, LIGHTGRAY);
-            DrawText(TextFormat("Function: %s", function_names[params.func_type]), functionButton.x + 10, functionButton.y + 5, 14, BLACK);
+                DrawRectangleRec(functionButton, LIGHTGRAY);
+                DrawText(TextFormat("Function: %s", function_names[params.func_type]), functionButton.x + 10, functionButton.y + 5, 14, BLACK);
             
-            DrawRectangleRec(seriesTypeButton, LIGHTGRAY);
-            DrawText(TextFormat("Series: %s", params.series_type == SERIES_TAYLOR ? "Taylor" : "Laurent"), 
-                     seriesTypeButton.x + 10, seriesTypeButton.y + 5, 20, BLACK);
+                DrawRectangleRec(seriesTypeButton, LIGHTGRAY);
+                DrawText(TextFormat("Series: %s", params.series_type == SERIES_TAYLOR ? "Taylor" : "Laurent"), 
+                         seriesTypeButton.x + 10, seriesTypeButton.y + 5, 20, BLACK);
                      
-            DrawRectangleRec(viewModeButton, LIGHTGRAY);
-            const char* viewNames[] = {"Original", "Approximation", "Error", "Split"};
-            DrawText(TextFormat("View: %s", viewNames[params.view_mode]), viewModeButton.x + 10, viewModeButton.y + 5, 20, BLACK);
+                DrawRectangleRec(viewModeButton, LIGHTGRAY);
+                const char* viewNames[] = {"Original", "Approximation", "Error", "Split"};
+                DrawText(TextFormat("View: %s", viewNames[params.view_mode]), viewModeButton.x + 10, viewModeButton.y + 5, 20, BLACK);
             
-            DrawRectangleRec(phaseLineButton, params.show_phase_lines ? SKYBLUE : LIGHTGRAY);
-            DrawText("Phase Lines", phaseLineButton.x + 10, phaseLineButton.y + 5, 20, BLACK);
+                DrawRectangleRec(phaseLineButton, params.show_phase_lines ? SKYBLUE : LIGHTGRAY);
+                DrawText("Phase Lines", phaseLineButton.x + 10, phaseLineButton.y + 5, 20, BLACK);
             
-            DrawRectangleRec(modulusLineButton, params.show_modulus_lines ? SKYBLUE : LIGHTGRAY);
-            DrawText("Modulus Lines", modulusLineButton.x + 10, modulusLineButton.y + 5, 20, BLACK);
+                DrawRectangleRec(modulusLineButton, params.show_modulus_lines ? SKYBLUE : LIGHTGRAY);
+                DrawText("Modulus Lines", modulusLineButton.x + 10, modulusLineButton.y + 5, 20, BLACK);
             
-            DrawRectangleRec(resetButton, LIGHTGRAY);
-            DrawText("Reset View", resetButton.x + 30, resetButton.y + 5, 20, BLACK);
-            
-            DrawText("Up/Down: Change terms, Left/Right: Change function", 10, SCREEN_HEIGHT - 150, 16, DARKGRAY);
-            DrawText("T: Taylor series, L: Laurent series, V: Change view", 10, SCREEN_HEIGHT - 170, 16, DARKGRAY);
-            DrawText("P: Toggle phase lines, M: Toggle modulus lines, R: Reset view", 10, SCREEN_HEIGHT - 190, 16, DARKGRAY);
-            DrawText("Mouse drag: pan view, Mouse wheel: zoom in/out", 10, SCREEN_HEIGHT - 210, 16, DARKGRAY);
+                DrawRectangleRec(resetButton, LIGHTGRAY);
+                DrawText("Reset View", resetButton.x + 30, resetButton.y + 5, 20, BLACK);
             
+                DrawText("Up/Down: Change terms, Left/Right: Change function", 10, SCREEN_HEIGHT - 150, 16, DARKGRAY);
+                DrawText("T: Taylor series, L: Laurent series, V: Change view", 10, SCREEN_HEIGHT - 170, 16, DARKGRAY);
+                DrawText("P: Toggle phase lines, M: Toggle modulus lines, R: Reset view", 10, SCREEN_HEIGHT - 190, 16, DARKGRAY);
+                DrawText("Mouse drag: pan view, Mouse wheel: zoom in/out", 10, SCREEN_HEIGHT - 210, 16, DARKGRAY);
+            overlay_layer_end(&chromeLayer);
+            shownParams = params;
+        }
+        
+        BeginDrawing();
+            ClearBackground(RAYWHITE);
+            DrawTexture(texture, 0, 0, WHITE);
+            overlay_layer_draw(&chromeLayer);
         EndDrawing();
     }
     
     UnloadImageColors(pixels);
+    UnloadRenderTexture(chromeLayer.target);
     UnloadTexture(texture);
     UnloadImage(colorImage);
     CloseWindow();